@@ -0,0 +1,632 @@
+/**
+ * Micro benchmarks for the Fraction hot paths.
+ * Build and run with: make bench && ./bench
+ */
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "sources/BigFraction.hpp"
+#include "sources/Fraction.hpp"
+#include "sources/HybridFraction.hpp"
+
+using namespace std;
+using namespace ariel;
+
+namespace {
+    template<typename T>
+    inline void keep(T const &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * Run body(i) for i in [0, iterations) and print the average time per call.
+     */
+    template<typename Body>
+    double timeIt(const string &name, size_t iterations, Body body) {
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            body(i);
+        }
+        chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+        double perOp = elapsed.count() / static_cast<double>(iterations);
+        cout << "  " << left << setw(44) << name << right << setw(10) << fixed << setprecision(2) << perOp
+             << " ns/op\n";
+        return perOp;
+    }
+
+    vector<int> randomInts(size_t count, int low, int high) {
+        mt19937 gen(12345);
+        uniform_int_distribution<int> dist(low, high);
+        vector<int> values(count);
+        for (int &value: values) {
+            value = dist(gen);
+        }
+        return values;
+    }
+
+    // The division-based checks Fraction used before the compiler builtins.
+    int legacyAddOvf(int _n1, int _n2) {
+        if (((_n1 >= 0) && (_n2 >= 0) && (_n1 > max_int - _n2)) ||
+            ((_n1 < 0) && (_n2 < 0) && (_n1 < min_int - _n2))) {
+            throw overflow_error("OVERFLOW ERROR!\n");
+        }
+        return _n1 + _n2;
+    }
+
+    int legacyMulOvf(int _n1, int _n2) {
+        if (((_n1 == -1) && (_n2 == min_int)) || ((_n1 == min_int) && (_n2 == -1))) {
+            throw overflow_error("OVERFLOW ERROR!\n");
+        }
+        int c = static_cast<int>(static_cast<unsigned>(_n1) * static_cast<unsigned>(_n2));
+        if (((_n1 != 0) && (c / _n1 != _n2))) {
+            throw overflow_error("OVERFLOW ERROR!\n");
+        }
+        return c;
+    }
+
+    void benchCheckedArithmetic() {
+        cout << "Checked integer arithmetic\n";
+        const size_t n = 1U << 12U;
+        const size_t rounds = 5000;
+        vector<int> a = randomInts(n, -40000, 40000), b = randomInts(n, -40000, 40000);
+        vector<int> out(n);
+        timeIt("legacy mulOvf (divide to check)", n * rounds, [&](size_t i) {
+            out[i % n] = legacyMulOvf(a[i % n], b[(i + 1) % n]);
+            keep(out[i % n]);
+        });
+        timeIt("mulOvf (__builtin_mul_overflow)", n * rounds, [&](size_t i) {
+            out[i % n] = mulOvf(a[i % n], b[(i + 1) % n]);
+            keep(out[i % n]);
+        });
+        timeIt("legacy addOvf", n * rounds, [&](size_t i) {
+            out[i % n] = legacyAddOvf(a[i % n], b[(i + 1) % n]);
+            keep(out[i % n]);
+        });
+        timeIt("addOvf (__builtin_add_overflow)", n * rounds, [&](size_t i) {
+            out[i % n] = addOvf(a[i % n], b[(i + 1) % n]);
+            keep(out[i % n]);
+        });
+    }
+
+    void benchFractionOperators() {
+        cout << "Fraction operators\n";
+        const size_t n = 1U << 12U;
+        const size_t rounds = 1000;
+        vector<int> nums = randomInts(n, -2000, 2000), dens = randomInts(n, 1, 2000);
+        vector<Fraction> fracs;
+        fracs.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            fracs.emplace_back(nums[i], dens[i]);
+        }
+        timeIt("operator+", n * rounds, [&](size_t i) { keep(fracs[i % n] + fracs[(i + 7) % n]); });
+        timeIt("operator-", n * rounds, [&](size_t i) { keep(fracs[i % n] - fracs[(i + 7) % n]); });
+        timeIt("operator*", n * rounds, [&](size_t i) { keep(fracs[i % n] * fracs[(i + 7) % n]); });
+        timeIt("operator/", n * rounds, [&](size_t i) {
+            const Fraction &divisor = fracs[(i + 7) % n];
+            keep(!divisor ? fracs[i % n] : fracs[i % n] / divisor);
+        });
+        timeIt("operator<", n * rounds, [&](size_t i) { keep(fracs[i % n] < fracs[(i + 7) % n]); });
+        timeIt("operator+ (Fraction(int) temporary)", n * rounds, [&](size_t i) {
+            keep(fracs[i % n] + Fraction(nums[(i + 7) % n]));
+        });
+        timeIt("operator+ (int)", n * rounds, [&](size_t i) { keep(fracs[i % n] + nums[(i + 7) % n]); });
+        timeIt("operator* (Fraction(int) temporary)", n * rounds, [&](size_t i) {
+            keep(fracs[i % n] * Fraction(nums[(i + 7) % n]));
+        });
+        timeIt("operator* (int)", n * rounds, [&](size_t i) { keep(fracs[i % n] * nums[(i + 7) % n]); });
+        timeIt("operator< (int)", n * rounds, [&](size_t i) { keep(fracs[i % n] < nums[(i + 7) % n]); });
+    }
+
+    /**
+     * Time a*b + c*d - e on small operands for one reduction policy, reading the result once,
+     * and report how many gcds each expression cost.
+     */
+    template<typename FractionT>
+    void benchExpression(const string &name, const vector<FractionT> &fracs, size_t rounds) {
+        const size_t n = fracs.size();
+        unsigned long long gcdsBefore = gcdCalls;
+        timeIt(name, n * rounds, [&](size_t i) {
+            FractionT value = fracs[i % n] * fracs[(i + 1) % n] + fracs[(i + 2) % n] * fracs[(i + 3) % n] -
+                              fracs[(i + 4) % n];
+            keep(value.getNumerator());
+        });
+        cout << "  " << left << setw(44) << "  gcd calls per expression" << right << setw(10) << fixed
+             << setprecision(2) << static_cast<double>(gcdCalls - gcdsBefore) / static_cast<double>(n * rounds)
+             << '\n';
+    }
+
+    /**
+     * Accumulation loop: a running sum of unit fractions, observed only at the end.
+     */
+    template<typename FractionT>
+    void benchAccumulation(const string &name, size_t loops) {
+        const int terms = 8;
+        unsigned long long gcdsBefore = gcdCalls;
+        timeIt(name, loops, [&](size_t) {
+            FractionT sum;
+            for (int d = 1; d <= terms; ++d) {
+                sum += FractionT(1, d);
+            }
+            keep(sum.getNumerator());
+        });
+        cout << "  " << left << setw(44) << "  gcd calls per loop" << right << setw(10) << fixed << setprecision(2)
+             << static_cast<double>(gcdCalls - gcdsBefore) / static_cast<double>(loops) << '\n';
+    }
+
+    void benchLazyReduction() {
+        cout << "Reduction policy (a*b + c*d - e, operands up to 60/60)\n";
+        const size_t n = 1U << 12U;
+        const size_t rounds = 500;
+        vector<int> nums = randomInts(n, -60, 60), dens = randomInts(n, 1, 60);
+        vector<Fraction> eager;
+        vector<LazyFraction> lazy;
+        for (size_t i = 0; i < n; ++i) {
+            eager.emplace_back(nums[i], dens[i]);
+            lazy.emplace_back(nums[i], dens[i]);
+        }
+        benchExpression("eager_reduce", eager, rounds);
+        benchExpression("lazy_reduce", lazy, rounds);
+
+        cout << "Reduction policy (sum += 1/d for d in 1..8, read once)\n";
+        benchAccumulation<Fraction>("eager_reduce", rounds * 100);
+        benchAccumulation<LazyFraction>("lazy_reduce", rounds * 100);
+    }
+
+    void benchConversions() {
+        cout << "Conversions from double\n";
+        const size_t n = 1U << 12U;
+        const size_t rounds = 1000;
+        vector<double> values(n);
+        mt19937_64 gen(99);
+        uniform_real_distribution<double> dist(-2000.0, 2000.0);
+        for (double &value: values) {
+            value = dist(gen);
+        }
+        timeIt("Fraction(double) (floor(x * 1000))", n * rounds, [&](size_t i) { keep(Fraction(values[i % n])); });
+        timeIt("Fraction::round_to_digits(x, 3)", n * rounds, [&](size_t i) {
+            keep(Fraction::round_to_digits(values[i % n], 3));
+        });
+        using Fraction64 = basic_fraction<int64_t>;
+        timeIt("Fraction64::from_exact(x)", n * rounds, [&](size_t i) { keep(Fraction64::from_exact(values[i % n])); });
+        timeIt("Fraction::from_double(x, 1000)", n * rounds, [&](size_t i) {
+            keep(Fraction::from_double(values[i % n], 1000));
+        });
+        vector<Fraction> out(n);
+        timeIt("Fraction::from_double(span, 1000) per element", n * rounds, [&](size_t i) {
+            if (i % n == 0) {
+                Fraction::from_double(values, out, 1000);
+                keep(out.front());
+            }
+        });
+    }
+
+    void benchExport() {
+        cout << "Conversions to double and float\n";
+        const size_t n = 1U << 12U;
+        const size_t rounds = 1000;
+        vector<int> nums = randomInts(n, -2000000, 2000000), dens = randomInts(n, 1, 2000000);
+        vector<Fraction> fracs;
+        fracs.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            fracs.emplace_back(nums[i], dens[i]);
+        }
+        timeIt("to_rounded_double() (old operator double)", n * rounds, [&](size_t i) {
+            keep(fracs[i % n].to_rounded_double());
+        });
+        timeIt("to_double()", n * rounds, [&](size_t i) { keep(fracs[i % n].to_double()); });
+        timeIt("to_float()", n * rounds, [&](size_t i) { keep(fracs[i % n].to_float()); });
+        vector<double> doubles(n);
+        timeIt("to_double(span) per element", n * rounds, [&](size_t i) {
+            if (i % n == 0) {
+                Fraction::to_double(fracs, doubles);
+                keep(doubles.front());
+            }
+        });
+        vector<float> floats(n);
+        timeIt("to_float(span) per element", n * rounds, [&](size_t i) {
+            if (i % n == 0) {
+                Fraction::to_float(fracs, floats);
+                keep(floats.front());
+            }
+        });
+        mt19937_64 gen(3);
+        vector<basic_fraction<int64_t>> wide;
+        for (size_t i = 0; i < n; ++i) {
+            wide.emplace_back(static_cast<int64_t>(gen() >> 1U), static_cast<int64_t>(gen() >> 1U) | 1);
+        }
+        timeIt("Fraction64::to_double() (63-bit parts)", n * rounds / 10, [&](size_t i) {
+            keep(wide[i % n].to_double());
+        });
+    }
+
+    /**
+     * Operand pairs shaped like fraction reduction inputs: products of random factors, so the
+     * gcd is often non-trivial, spread over the full bit range of the type.
+     */
+    template<typename UIntT>
+    vector<pair<UIntT, UIntT>> gcdInputs(size_t count, int bits) {
+        mt19937_64 gen(2024);
+        auto randomBits = [&](int width) {
+            auto value = static_cast<unsigned __int128>(gen()) << 64U | gen();
+            return static_cast<UIntT>(value >> static_cast<unsigned>(128 - width)) | 1U;
+        };
+        vector<pair<UIntT, UIntT>> pairs(count);
+        for (auto &[first, second]: pairs) {
+            int commonBits = 1 + static_cast<int>(gen() % static_cast<unsigned>(bits / 2));
+            UIntT common = randomBits(commonBits);
+            first = common * randomBits(bits - commonBits);
+            second = common * randomBits(bits - commonBits);
+        }
+        return pairs;
+    }
+
+    template<typename UIntT>
+    UIntT euclidGcd(UIntT _n1, UIntT _n2) {
+        while (_n2 != 0) {
+            UIntT rem = _n1 % _n2;
+            _n1 = _n2;
+            _n2 = rem;
+        }
+        return _n1;
+    }
+
+    template<typename UIntT>
+    void benchGcdWidth(const string &label, int bits) {
+        const size_t n = 1U << 12U;
+        const size_t rounds = 200;
+        auto pairs = gcdInputs<UIntT>(n, bits);
+        if constexpr (sizeof(UIntT) <= 8) {
+            timeIt(label + " std::gcd", n * rounds, [&](size_t i) {
+                keep(std::gcd(pairs[i % n].first, pairs[i % n].second));
+            });
+        } else {
+            timeIt(label + " Euclid", n * rounds, [&](size_t i) {
+                keep(euclidGcd(pairs[i % n].first, pairs[i % n].second));
+            });
+        }
+        timeIt(label + " binaryGcd", n * rounds, [&](size_t i) {
+            keep(binaryGcd(pairs[i % n].first, pairs[i % n].second));
+        });
+    }
+
+    void benchGcd() {
+        cout << "GCD kernels\n";
+        benchGcdWidth<unsigned>("32-bit", 31);
+        benchGcdWidth<unsigned long long>("64-bit", 63);
+        benchGcdWidth<unsigned __int128>("128-bit", 127);
+    }
+
+    void benchParsing() {
+        cout << "Parsing \"n d\" text\n";
+        const size_t n = 1U << 14U;
+        const size_t rounds = 20;
+        auto nums = randomInts(n, -1000000, 1000000);
+        auto dens = randomInts(n, 1, 1000000);
+        string text;
+        for (size_t i = 0; i < n; ++i) {
+            text += to_string(nums[i]) + ' ' + to_string(dens[i]) + '\n';
+        }
+        Fraction value;
+        timeIt("operator>> (istringstream)", n * rounds, [&](size_t i) {
+            static istringstream input;
+            if (i % n == 0) {
+                input.clear();
+                input.str(text);
+            }
+            input >> value;
+            keep(value);
+        });
+        const char *pos = text.data();
+        const char *end = pos + text.size();
+        timeIt("from_chars()", n * rounds, [&](size_t i) {
+            if (i % n == 0) {
+                pos = text.data();
+            }
+            pos = from_chars(pos, end, value).ptr + 1;
+            keep(value);
+        });
+
+        string decimals;
+        for (size_t i = 0; i < n; ++i) {
+            decimals += to_string(nums[i] / 1000) + '.' + to_string(dens[i] % 1000) + '\n';
+        }
+        const char *decimalEnd = decimals.data() + decimals.size();
+        // What callers did before: parse a double, then keep 3 decimals through Fraction(double).
+        timeIt("std::from_chars() double + Fraction(double)", n * rounds, [&](size_t i) {
+            if (i % n == 0) {
+                pos = decimals.data();
+            }
+            double x = 0;
+            pos = std::from_chars(pos, decimalEnd, x).ptr + 1;
+            keep(Fraction(x));
+        });
+        timeIt("from_chars() decimal", n * rounds, [&](size_t i) {
+            if (i % n == 0) {
+                pos = decimals.data();
+            }
+            pos = from_chars(pos, decimalEnd, value, fraction_format::decimal).ptr + 1;
+            keep(value);
+        });
+    }
+
+    void benchFormatting() {
+        cout << "Formatting \"n/d\" text\n";
+        const size_t n = 1U << 14U;
+        const size_t rounds = 20;
+        auto nums = randomInts(n, -1000000, 1000000);
+        auto dens = randomInts(n, 1, 1000000);
+        vector<Fraction> values;
+        for (size_t i = 0; i < n; ++i) {
+            values.emplace_back(nums[i], dens[i]);
+        }
+        ostringstream out;
+        // What operator<< did before to_chars(): three formatted insertions.
+        timeIt("numerator << '/' << denominator", n * rounds, [&](size_t i) {
+            if (i % n == 0) {
+                out.str("");
+            }
+            out << values[i % n].getNumerator() << '/' << values[i % n].getDenominator();
+        });
+        timeIt("operator<<", n * rounds, [&](size_t i) {
+            if (i % n == 0) {
+                out.str("");
+            }
+            out << values[i % n];
+        });
+        char text[32];
+        timeIt("to_chars()", n * rounds, [&](size_t i) {
+            keep(to_chars(begin(text), end(text), values[i % n]).ptr);
+        });
+        timeIt("to_chars() decimal, 6 digits", n * rounds, [&](size_t i) {
+            keep(to_chars(begin(text), end(text), values[i % n], fraction_format::decimal, 6).ptr);
+        });
+
+        vector<basic_fraction<int64_t>> wide;
+        mt19937_64 gen(7);
+        for (size_t i = 0; i < n; ++i) {
+            wide.emplace_back(static_cast<int64_t>(gen() >> 1U), static_cast<int64_t>(gen() >> 1U) | 1);
+        }
+        char digits[64];
+        // One division per digit, as to_chars() did before longDivision().
+        timeIt("36 digits, one divide per digit", n * rounds / 4, [&](size_t i) {
+            auto rem = static_cast<unsigned __int128>(wide[i % n].getNumerator() % wide[i % n].getDenominator());
+            auto den = static_cast<unsigned __int128>(wide[i % n].getDenominator());
+            for (char &digit: span(digits, 36)) {
+                rem *= 10U;
+                digit = static_cast<char>('0' + static_cast<int>(rem / den));
+                rem %= den;
+            }
+            keep(digits);
+        });
+        timeIt("36 digits, longDivision()", n * rounds / 4, [&](size_t i) {
+            auto rem = static_cast<unsigned __int128>(wide[i % n].getNumerator() % wide[i % n].getDenominator());
+            keep(longDivision(rem, static_cast<unsigned __int128>(wide[i % n].getDenominator()), 36, digits));
+        });
+        timeIt("to_decimal(36 digits)", n * rounds / 4, [&](size_t i) {
+            keep(to_decimal(wide[i % n], 36));
+        });
+        vector<Fraction> small;
+        for (size_t i = 0; i < n; ++i) {
+            small.emplace_back(nums[i], dens[i] % 1000 + 1);
+        }
+        timeIt("to_decimal(1000, true), den <= 1000", n * rounds / 20, [&](size_t i) {
+            keep(to_decimal(small[i % n], 1000, true));
+        });
+    }
+
+    void benchOverflowHandling() {
+        cout << "Overflow handling (every other add overflows)\n";
+        const size_t iterations = 200000;
+        Fraction big(max_int - 1, 1), one(1), huge(max_int, 1);
+        size_t overflows = 0;
+        timeIt("operator+ with try/catch", iterations, [&](size_t i) {
+            try {
+                keep((i % 2 == 0 ? big : huge) + one);
+            } catch (const overflow_error &) {
+                ++overflows;
+            }
+        });
+        timeIt("checked_add", iterations, [&](size_t i) {
+            auto sum = checked_add(i % 2 == 0 ? big : huge, one);
+            overflows += sum.has_value() ? 0U : 1U;
+            keep(sum);
+        });
+        using SaturatingFraction = basic_fraction<int, eager_reduce, saturate_on_overflow>;
+        SaturatingFraction satBig(max_int - 1, 1), satOne(1), satHuge(max_int, 1);
+        timeIt("operator+ with saturate_on_overflow", iterations, [&](size_t i) {
+            keep((i % 2 == 0 ? satBig : satHuge) + satOne);
+        });
+        keep(overflows);
+    }
+
+    void benchBigFraction() {
+        cout << "BigFraction accumulation\n";
+        const size_t iterations = 1000000;
+        // Denominators dividing 720720 keep the running sum's denominator bounded.
+        vector<int> numerators = randomInts(iterations, -1000, 1000), divisors = randomInts(iterations, 1, 240);
+        vector<int> denominators(iterations);
+        for (size_t i = 0; i < iterations; ++i) {
+            denominators[i] = gcd(720720, divisors[i]);
+        }
+        basic_fraction<__int128> narrowSum;
+        timeIt("Fraction128 +=, bounded denominators", iterations, [&](size_t i) {
+            narrowSum += basic_fraction<__int128>(numerators[i], denominators[i]);
+        });
+        BigFraction sum;
+        timeIt("BigFraction +=, bounded denominators", iterations, [&](size_t i) {
+            sum += BigFraction(numerators[i], denominators[i]);
+        });
+        keep(narrowSum);
+        if (sum.to_fraction<basic_fraction<__int128>>() != narrowSum) {
+            cout << "  MISMATCH\n";
+        }
+        BigFraction harmonic;
+        timeIt("BigFraction += 1/i, i <= 5000 (growing)", 5000, [&](size_t i) {
+            harmonic += BigFraction(1, static_cast<int>(i) + 1);
+        });
+        cout << "  H(5000) denominator: " << harmonic.getDenominator().bit_width() << " bits\n";
+    }
+
+    void benchBigMultiplication() {
+        cout << "BigInt multiplication by operand size (crossover points)\n";
+        // A "one ... step" row splits only at the top level and hands the parts to the row above
+        // it, so a step pays off from the first size at which it beats that row.
+        const BigInt::tuning tuned = BigInt::default_tuning;
+        constexpr size_t never = ~size_t(0);
+        mt19937_64 gen(12345);
+        for (size_t limbs = 16; limbs <= 2048; limbs *= 2) {
+            BigInt a = 1, b = 1;
+            for (size_t i = 1; i < limbs; ++i) {
+                a = (a << 64U) + BigInt(static_cast<__int128>(gen()));
+                b = (b << 64U) + BigInt(static_cast<__int128>(gen()));
+            }
+            const pair<string, BigInt::tuning> algorithms[] = {
+                    {"schoolbook", {never, never, never, never}},
+                    {"one Karatsuba step", {limbs, never, limbs, never}},
+                    {"Karatsuba", {tuned.karatsuba, never, tuned.karatsuba_square, never}},
+                    {"one Toom-3 step", {tuned.karatsuba, limbs, tuned.karatsuba_square, limbs}},
+            };
+            size_t iterations = max<size_t>(20, 4000000 / (limbs * limbs));
+            for (bool square: {false, true}) {
+                for (const auto &[name, sizes]: algorithms) {
+                    BigInt::tuning_override algorithm(sizes);
+                    timeIt((square ? "a * a, " : "a * b, ") + to_string(limbs) + " limbs, " + name, iterations,
+                           [&](size_t) {
+                               keep(square ? a * a : a * b);
+                           });
+                }
+            }
+        }
+    }
+
+    void benchBigGcd() {
+        cout << "BigInt gcd by operand size (Lehmer vs half-gcd)\n";
+        mt19937_64 gen(12345);
+        for (size_t limbs = 256; limbs <= 4096; limbs *= 2) {
+            BigInt a = 1, b = 1;
+            for (size_t i = 1; i < limbs; ++i) {
+                a = (a << 64U) + BigInt(static_cast<__int128>(gen()));
+                b = (b << 64U) + BigInt(static_cast<__int128>(gen()));
+            }
+            size_t iterations = max<size_t>(3, 20000000 / (limbs * limbs));
+            for (bool halving: {false, true}) {
+                BigInt::tuning_override algorithm({.half_gcd = halving ? 0 : ~size_t(0)});
+                timeIt("gcd, " + to_string(limbs) + " limbs, " + (halving ? "half-gcd" : "Lehmer"), iterations,
+                       [&](size_t) {
+                           keep(gcd(a, b));
+                       });
+            }
+        }
+        // A 4096-limb fraction with a 1024-limb common factor, reduced on construction.
+        BigInt common = 1, numerator = 1, denominator = 1;
+        for (size_t i = 1; i < 3072; ++i) {
+            numerator = (numerator << 64U) + BigInt(static_cast<__int128>(gen()));
+            denominator = (denominator << 64U) + BigInt(static_cast<__int128>(gen()));
+            common = i < 1024 ? (common << 64U) + BigInt(static_cast<__int128>(gen())) : common;
+        }
+        numerator *= common;
+        denominator *= common;
+        timeIt("BigFraction(n, d), 4096 limbs", 3, [&](size_t) {
+            keep(BigFraction(numerator, denominator));
+        });
+    }
+
+    void benchBigDecimal() {
+        cout << "BigInt / BigFraction decimal I/O by digit count\n";
+        mt19937_64 gen(12345);
+        for (size_t digits = 1000; digits <= 100000; digits *= 10) {
+            string text(digits, '0');
+            for (char &c: text) {
+                c = static_cast<char>('0' + gen() % 10U);
+            }
+            text[0] = '7';
+            BigInt value;
+            from_chars(text.data(), text.data() + text.size(), value);
+            size_t iterations = max<size_t>(3, 100000000 / (digits * 100));
+            string size = to_string(digits) + " digits";
+            timeIt("to_string(), " + size, iterations, [&](size_t) {
+                keep(value.to_string());
+            });
+            timeIt("from_chars(), " + size, iterations, [&](size_t) {
+                BigInt parsed;
+                from_chars(text.data(), text.data() + text.size(), parsed);
+                keep(parsed);
+            });
+            BigFraction frac(value, value * 3 + 1);
+            string pair = frac.to_string();
+            timeIt("BigFraction operator<<, " + size + " each", iterations, [&](size_t) {
+                ostringstream out;
+                out << frac;
+                keep(out.str().size());
+            });
+            timeIt("BigFraction operator>>, " + size + " each", iterations, [&](size_t) {
+                istringstream in(pair);
+                BigFraction read;
+                in >> read;
+                keep(read);
+            });
+        }
+    }
+
+    void benchHybridFraction() {
+        cout << "HybridFraction (int64_t inline, BigFraction on overflow)\n";
+        const size_t iterations = 1000000;
+        vector<int> numerators = randomInts(iterations, -1000, 1000), denominators = randomInts(iterations, 1, 1000);
+        vector<basic_fraction<int64_t>> narrow(iterations);
+        vector<HybridFraction> hybrid(iterations);
+        for (size_t i = 0; i < iterations; ++i) {
+            narrow[i] = basic_fraction<int64_t>(numerators[i], denominators[i]);
+            hybrid[i] = narrow[i];
+        }
+        timeIt("Fraction64 a + b", iterations - 1, [&](size_t i) {
+            keep(narrow[i] + narrow[i + 1]);
+        });
+        timeIt("HybridFraction a + b, both small", iterations - 1, [&](size_t i) {
+            keep(hybrid[i] + hybrid[i + 1]);
+        });
+        timeIt("Fraction64 a * b", iterations - 1, [&](size_t i) {
+            keep(narrow[i] * narrow[i + 1]);
+        });
+        timeIt("HybridFraction a * b, both small", iterations - 1, [&](size_t i) {
+            keep(hybrid[i] * hybrid[i + 1]);
+        });
+        HybridFraction huge(fraction_traits<int64_t>::max, 3);
+        timeIt("HybridFraction a * max/3, promotes", iterations / 10, [&](size_t i) {
+            keep(hybrid[i] * huge);
+        });
+        // Bounded denominators: the sum stays inline, as with Fraction128 in benchBigFraction().
+        HybridFraction sum;
+        timeIt("HybridFraction +=, bounded denominators", iterations, [&](size_t i) {
+            sum += HybridFraction(numerators[i], gcd(720720, denominators[i]));
+        });
+        cout << "  sum is " << (sum.is_small() ? "small" : "big") << "\n";
+    }
+}
+
+int main() {
+    benchCheckedArithmetic();
+    benchGcd();
+    benchFractionOperators();
+    benchLazyReduction();
+    benchConversions();
+    benchExport();
+    benchParsing();
+    benchFormatting();
+    benchOverflowHandling();
+    benchBigFraction();
+    benchBigMultiplication();
+    benchBigGcd();
+    benchBigDecimal();
+    benchHybridFraction();
+    return 0;
+}
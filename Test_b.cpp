@@ -0,0 +1,1347 @@
+#include "doctest.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "sources/BigFraction.hpp"
+#include "sources/Fraction.hpp"
+#include "sources/HybridFraction.hpp"
+
+using namespace std;
+using namespace ariel;
+
+// Everything below is evaluated by the compiler; a failure here is a build error.
+static_assert(Fraction(2, 4).getNumerator() == 1 && Fraction(2, 4).getDenominator() == 2);
+static_assert(Fraction(3, -9).getNumerator() == -1 && Fraction(3, -9).getDenominator() == 3);
+static_assert((Fraction(1, 2) + Fraction(1, 3)).getNumerator() == 5);
+static_assert((Fraction(1, 2) - Fraction(1, 3)).getDenominator() == 6);
+static_assert((Fraction(2, 3) * Fraction(3, 4)).getNumerator() == 1);
+static_assert((Fraction(2, 3) / Fraction(4, 3)).getDenominator() == 2);
+static_assert((-Fraction(1, 2)).getNumerator() == -1);
+static_assert(!Fraction(0, 5));
+static_assert(addOvf(max_int - 1, 1) == max_int);
+static_assert(mulOvf(-46340, 46340) == -2147395600);
+
+constexpr Fraction harmonic(int n) {
+    Fraction sum;
+    for (int i = 1; i <= n; ++i) {
+        sum += Fraction(1, i);
+    }
+    return sum;
+}
+
+static_assert(harmonic(4).getNumerator() == 25 && harmonic(4).getDenominator() == 12);
+
+constexpr Fraction stepped() {
+    Fraction f(1, 2);
+    ++f;
+    f++;
+    --f;
+    f *= Fraction(2, 5);
+    f -= Fraction(1, 5);
+    return f;
+}
+
+static_assert(stepped().getNumerator() == 2 && stepped().getDenominator() == 5);
+
+TEST_CASE("constexpr arithmetic matches runtime arithmetic") {
+    Fraction a(1, 2), b(1, 3);
+    constexpr Fraction c = Fraction(1, 2) + Fraction(1, 3);
+    CHECK((a + b).getNumerator() == c.getNumerator());
+    CHECK((a + b).getDenominator() == c.getDenominator());
+    CHECK(harmonic(4).getNumerator() == 25);
+}
+
+TEST_CASE("Overflow checks still throw at runtime") {
+    CHECK_THROWS_AS(addOvf(max_int, 1), std::overflow_error);
+    CHECK_THROWS_AS(addOvf(min_int, -1), std::overflow_error);
+    CHECK_THROWS_AS(mulOvf(min_int, -1), std::overflow_error);
+    CHECK_THROWS_AS(mulOvf(65536, 65536), std::overflow_error);
+    CHECK_THROWS_AS(mulOvf(-65536, 65536), std::overflow_error);
+    CHECK_NOTHROW(mulOvf(min_int, 1));
+    CHECK_NOTHROW(mulOvf(-1, max_int));
+}
+
+static_assert(Fraction(1, 3) < Fraction(1, 2));
+static_assert(Fraction(-1, 2) <= Fraction(1, -2));
+static_assert((Fraction(2, 4) <=> Fraction(1, 2)) == 0);
+static_assert((Fraction(max_int, 1) <=> Fraction(max_int - 1, 1)) > 0);
+
+TEST_CASE("Exact comparisons of close and extreme values") {
+    Fraction a(1, 100001), b(1, 100002);
+    CHECK(a > b);
+    CHECK(b < a);
+    CHECK_FALSE(a <= b);
+    CHECK((a <=> b) == std::strong_ordering::greater);
+
+    Fraction big(max_int - 1, max_int), bigger(max_int, max_int - 1);
+    CHECK(big < bigger);
+    CHECK(Fraction(min_int, 1) < Fraction(-max_int, 1));
+    CHECK(Fraction(min_int, max_int) < Fraction(-1, 1));
+}
+
+TEST_CASE("Sorting uses the exact order") {
+    std::vector<Fraction> fracs = {Fraction{3, 7}, Fraction{1, 100002}, Fraction{-2, 5},
+                                   Fraction{1, 100001}, Fraction{3, 8}};
+    std::sort(fracs.begin(), fracs.end());
+    CHECK(std::is_sorted(fracs.begin(), fracs.end()));
+    CHECK(fracs[0].getNumerator() == -2);
+    CHECK(fracs[1].getDenominator() == 100002);
+    CHECK(fracs[2].getDenominator() == 100001);
+    CHECK(std::binary_search(fracs.begin(), fracs.end(), Fraction{3, 8}));
+}
+
+static_assert(Fraction(2, 4) == Fraction(1, 2));
+static_assert(Fraction(1, 3) != Fraction(333, 1000));
+
+TEST_CASE("Exact equality and the explicit tolerant comparison") {
+    Fraction third(1, 3), approx(333, 1000);
+    CHECK(third != approx);
+    CHECK_FALSE(third == approx);
+    CHECK(approx_equal(third, approx));
+    CHECK_FALSE(approx_equal(third, approx, 0.0001));
+    CHECK(Fraction(1, 100001) != Fraction(1, 100002));
+
+    // Comparing with a double stays tolerant.
+    CHECK(third == 0.3333);
+    CHECK(0.3333 == third);
+    CHECK(third != 0.5);
+    CHECK(approx_equal(third, 1.0 / 3, 1e-9));
+}
+
+using Fraction64 = basic_fraction<int64_t>;
+using Fraction128 = basic_fraction<__int128>;
+
+static_assert(std::is_same_v<Fraction, basic_fraction<int>>);
+static_assert((Fraction64(max_int, 1) * Fraction64(max_int, 1)).getNumerator() ==
+              static_cast<int64_t>(max_int) * max_int);
+static_assert(Fraction128(1, 3) < Fraction128(1, 2));
+static_assert(Fraction128(-7, 3) < Fraction128(-9, 4));
+
+TEST_CASE("Wider instantiations hold results that overflow int") {
+    Fraction f(max_int, 1);
+    CHECK_THROWS_AS(f * f, std::overflow_error);
+
+    Fraction64 g(max_int, 1);
+    Fraction64 g2 = g * g;
+    CHECK(g2.getNumerator() == 4611686014132420609LL);
+    CHECK_THROWS_AS(g2 * g2, std::overflow_error);
+
+    Fraction128 h = Fraction128(g2.getNumerator(), 1) * Fraction128(g2.getNumerator(), 3);
+    CHECK(h / Fraction128(g2.getNumerator(), 1) == Fraction128(g2.getNumerator(), 3));
+    CHECK(h > Fraction128(g2.getNumerator(), 1));
+
+    std::ostringstream os;
+    os << Fraction128(-123456789, 1) * Fraction128(100000000000LL, 7);
+    CHECK(os.str() == "-12345678900000000000/7");
+}
+
+TEST_CASE("Exact ordering without a wider type") {
+    __int128 big = fraction_traits<__int128>::max;
+    Fraction128 a(big - 1, big), b(big - 2, big - 1);
+    CHECK(b < a);
+    CHECK(a > b);
+    CHECK(Fraction128(-big, big - 1) < Fraction128(-1, 1));
+    CHECK((Fraction128(6, 4) <=> Fraction128(3, 2)) == 0);
+    // The floor quotient of min / 3 times 3 is below min; the remainders must not come from it.
+    __int128 least = fraction_traits<__int128>::min;
+    CHECK((Fraction128(least, 3) <=> Fraction128(least, 3)) == 0);
+    CHECK(Fraction128(least, 3) < Fraction128(least + 1, 3));
+    CHECK(Fraction128(least, 3) > Fraction128(least, 2));
+    CHECK(Fraction128(least + 1, 7) < Fraction128(least + 2, 7));
+}
+
+TEST_CASE("Integer constructor narrows with a check") {
+    CHECK(Fraction64(5) + 1 == Fraction64(6, 1));
+    CHECK(Fraction(int64_t{7}).getNumerator() == 7);
+    CHECK_THROWS_AS(Fraction(int64_t{1} << 40), std::overflow_error);
+}
+
+static_assert(subOvf(min_int + 1, 1) == min_int);
+static_assert(negOvf(max_int) == -max_int);
+static_assert(mulOvf(int64_t{1} << 31, int64_t{1} << 31) == int64_t{1} << 62);
+
+TEST_CASE("Builtin overflow checks at every width") {
+    CHECK_THROWS_AS(subOvf(min_int, 1), std::overflow_error);
+    CHECK_THROWS_AS(negOvf(min_int), std::overflow_error);
+    CHECK_THROWS_AS(mulOvf(int64_t{1} << 32, int64_t{1} << 31), std::overflow_error);
+    CHECK_NOTHROW(mulOvf(-(int64_t{1} << 32), int64_t{1} << 31));
+    __int128 big = fraction_traits<__int128>::max;
+    CHECK_THROWS_AS(addOvf(big, __int128{1}), std::overflow_error);
+    CHECK_THROWS_AS(mulOvf(big / 2 + 1, __int128{2}), std::overflow_error);
+    CHECK_THROWS_AS(-Fraction(min_int, 1), std::overflow_error);
+    CHECK_THROWS_AS(--Fraction(min_int, 1), std::overflow_error);
+}
+
+static_assert(!checked_add(Fraction(max_int, 1), Fraction(1, 1)).has_value());
+static_assert(*checked_mul(Fraction(2, 3), Fraction(3, 4)) == Fraction(1, 2));
+
+TEST_CASE("Checked arithmetic reports overflow without throwing") {
+    Fraction big(max_int, 1), small(1, max_int);
+    CHECK_FALSE(checked_add(big, Fraction(1)).has_value());
+    CHECK_FALSE(checked_sub(Fraction(min_int, 1), Fraction(1)).has_value());
+    CHECK_FALSE(checked_mul(small, Fraction(1, 2)).has_value());
+    CHECK_FALSE(checked_div(Fraction(1, 2), Fraction(0)).has_value());
+    CHECK_FALSE(checked_div(Fraction(1, 1), Fraction(min_int, 1)).has_value());
+    CHECK_FALSE(checked_increment(big).has_value());
+    CHECK_FALSE(checked_decrement(Fraction(min_int, 1)).has_value());
+    CHECK(noexcept(checked_add(big, small)));
+
+    CHECK(*checked_add(Fraction(1, 2), Fraction(1, 3)) == Fraction(5, 6));
+    CHECK(*checked_sub(Fraction(1, 2), Fraction(1, 3)) == Fraction(1, 6));
+    CHECK(*checked_div(Fraction(1, 2), Fraction(-1, 3)) == Fraction(-3, 2));
+    CHECK(*checked_increment(Fraction(-1, 2)) == Fraction(1, 2));
+    CHECK(*checked_decrement(Fraction(1, 2)) == Fraction(-1, 2));
+}
+
+TEST_CASE("Checked conversions from floating point") {
+    CHECK(*Fraction::checked_from(0.3333) == Fraction(333, 1000));
+    CHECK(*Fraction::checked_from(0.4F) == Fraction(2, 5));
+    CHECK_FALSE(Fraction::checked_from(1e7).has_value());
+    CHECK_FALSE(Fraction::checked_from(std::nan("")).has_value());
+    CHECK(Fraction64::checked_from(1e7).has_value());
+    CHECK_THROWS_AS(Fraction(1e7), std::overflow_error);
+}
+
+TEST_CASE("Falling back to a wider type on overflow") {
+    Fraction sum(max_int - 1, 1);
+    Fraction64 wide(0);
+    for (int i = 0; i < 3; ++i) {
+        if (auto next = checked_add(sum, Fraction(1))) {
+            sum = *next;
+        } else {
+            wide = Fraction64(sum.getNumerator(), sum.getDenominator()) + Fraction64(1);
+        }
+    }
+    CHECK(sum == Fraction(max_int, 1));
+    CHECK(wide == Fraction64(int64_t{max_int} + 1, 1));
+}
+
+static_assert(Fraction(46341, 2) * Fraction(2, 46341) == Fraction(1));
+static_assert(Fraction(1, 6) + Fraction(1, 10) == Fraction(4, 15));
+
+TEST_CASE("Cross-cancellation avoids spurious overflow") {
+    CHECK(Fraction(46341, 2) * Fraction(2, 46341) == Fraction(1));
+    CHECK(Fraction(46341, 2) / Fraction(46341, 2) == Fraction(1));
+    CHECK(Fraction(-46341, 7) / Fraction(46341, -14) == Fraction(2));
+
+    // The product of the denominators overflows, their LCM does not.
+    Fraction a(1, 65536 * 3), b(1, 65536 * 5);
+    CHECK(a + b == Fraction(8, 65536 * 15));
+    CHECK(a - b == Fraction(2, 65536 * 15));
+    Fraction c(1, 2000000000), d(1, -2000000000);
+    CHECK(c + d == Fraction(0));
+    CHECK(c - d == Fraction(1, 1000000000));
+    CHECK(!checked_mul(Fraction(1, 65536), Fraction(1, 65536)).has_value());
+    CHECK_THROWS_AS(Fraction(min_int, 3) / Fraction(-1, 3), std::overflow_error);
+}
+
+TEST_CASE("Sums only overflow when the reduced result does not fit") {
+    // max/2 + max/2: the unreduced numerator 2*max overflows, the result max/1 does not.
+    CHECK(Fraction(max_int, 2) + Fraction(max_int, 2) == Fraction(max_int, 1));
+    CHECK(Fraction(max_int, 2) - Fraction(-max_int, 2) == Fraction(max_int, 1));
+    CHECK(Fraction(min_int + 1, 2) + Fraction(min_int + 1, 2) == Fraction(min_int + 1, 1));
+    Fraction sum(max_int, 6);
+    sum += Fraction(max_int, 6);
+    sum += Fraction(max_int, 6);
+    CHECK(sum == Fraction(max_int, 2));
+    CHECK_THROWS_AS(Fraction(max_int, 2) + Fraction(max_int, 2) + Fraction(1), std::overflow_error);
+    CHECK(Fraction64(INT64_MAX, 2) + Fraction64(INT64_MAX, 2) == Fraction64(INT64_MAX, 1));
+    // __int128 has no wider type; the sum is redone in double width instead.
+    __int128 big = fraction_traits<__int128>::max, least = fraction_traits<__int128>::min;
+    CHECK(Fraction128(big, 2) + Fraction128(big, 2) == Fraction128(big, 1));
+    CHECK(Fraction128(big, 3) - Fraction128(-big, 6) == Fraction128(big, 2));
+    CHECK(Fraction128(least + 1, 2) + Fraction128(least + 1, 2) == Fraction128(least + 1, 1));
+    CHECK_THROWS_AS(Fraction128(big, 2) + Fraction128(big, 2) + Fraction128(1), std::overflow_error);
+    // Sums whose cross products overflow __int128 but whose reduced result fits: big numerators
+    // over a shared even denominator, and near-cancelling terms over coprime ones.
+    std::mt19937_64 gen(29);
+    auto sign = [&gen]() { return gen() % 2 == 0 ? 1 : -1; };
+    bool exact = true;
+    for (int i = 0; i < 2000; ++i) {
+        Fraction128 a, b;
+        if (i % 2 == 0) {
+            auto den = static_cast<__int128>(gen() >> 34U) * 2 + 2;
+            a = Fraction128(static_cast<__int128>((static_cast<unsigned __int128>(gen()) << 62U) | 1) * sign(), den);
+            b = Fraction128(static_cast<__int128>((static_cast<unsigned __int128>(gen()) << 62U) | 1) * sign(), den);
+        } else {
+            auto den1 = static_cast<__int128>(gen() >> 34U) + 1, den2 = static_cast<__int128>(gen() >> 34U) + 1;
+            auto num1 = static_cast<__int128>(static_cast<unsigned __int128>(gen()) << 36U) * sign();
+            BigInt num2 = -(BigInt(num1) * BigInt(den2) / BigInt(den1)) + BigInt(static_cast<int>(gen() % 5) - 2);
+            a = Fraction128(num1, den1);
+            b = Fraction128(num2.to_int<__int128>(), den2);
+        }
+        BigFraction expected = BigFraction(a) + BigFraction(b);
+        exact = exact && checked_add(a, b) == expected.checked_to_fraction<Fraction128>() &&
+                checked_sub(a, -b) == expected.checked_to_fraction<Fraction128>();
+    }
+    CHECK(exact);
+}
+
+static_assert(std::is_trivially_copy_constructible_v<Fraction> && std::is_trivially_move_assignable_v<Fraction>);
+static_assert(std::is_trivially_destructible_v<Fraction128>);
+
+TEST_CASE("Trivially copyable fractions keep their value through memcpy and atomics") {
+    std::vector<Fraction> fracs;
+    for (int i = 1; i <= 100; ++i) {
+        fracs.emplace_back(i, 2 * i + 2);
+    }
+    std::vector<Fraction> copy(fracs.size());
+    std::memcpy(copy.data(), fracs.data(), fracs.size() * sizeof(Fraction));
+    CHECK(copy == fracs);
+    CHECK(copy[2] == Fraction(3, 8));
+
+    std::atomic<Fraction> shared{Fraction(1, 2)};
+    Fraction expected = shared.load();
+    CHECK(shared.compare_exchange_strong(expected, expected + Fraction(1, 3)));
+    CHECK(shared.load() == Fraction(5, 6));
+}
+
+static_assert(binaryGcd(48U, 180U) == 12U);
+static_assert(gcdOf(min_int, 6) == 2);
+
+TEST_CASE("GCD kernels agree with Euclid") {
+    std::mt19937_64 gen(7);
+    auto euclid = [](unsigned __int128 a, unsigned __int128 b) {
+        while (b != 0) {
+            unsigned __int128 r = a % b;
+            a = b;
+            b = r;
+        }
+        return a;
+    };
+    for (int i = 0; i < 500; ++i) {
+        unsigned __int128 common = gen() >> (gen() % 64);
+        auto a = (static_cast<unsigned __int128>(gen()) >> (gen() % 64)) * (common | 1U);
+        auto b = (static_cast<unsigned __int128>(gen()) >> (gen() % 64)) * (common | 1U);
+        unsigned __int128 expected = euclid(a, b);
+        CHECK((binaryGcd(a, b) == expected));
+        auto a64 = static_cast<unsigned long long>(a), b64 = static_cast<unsigned long long>(b);
+        CHECK(binaryGcd(a64, b64) == std::gcd(a64, b64));
+    }
+    CHECK(gcdOf(0, 0) == 0);
+    CHECK(gcdOf(-12, 0) == 12);
+    CHECK(gcdOf(int64_t{-36}, int64_t{-48}) == 12);
+}
+
+static_assert(LazyFraction(2, 4) == LazyFraction(1, 2));
+static_assert(LazyFraction(1, 6) + LazyFraction(1, 3) == LazyFraction(1, 2));
+static_assert(std::is_trivially_copyable_v<LazyFraction> && sizeof(LazyFraction) == sizeof(Fraction));
+
+TEST_CASE("Lazy reduction gives the same values as eager reduction") {
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> num(-60, 60), den(1, 60);
+    for (int i = 0; i < 300; ++i) {
+        int n[4], d[4];
+        for (int k = 0; k < 4; ++k) {
+            n[k] = num(gen);
+            d[k] = den(gen);
+        }
+        Fraction eager = Fraction(n[0], d[0]) * Fraction(n[1], d[1]) + Fraction(n[2], d[2]) - Fraction(n[3], d[3]);
+        LazyFraction lazy =
+                LazyFraction(n[0], d[0]) * LazyFraction(n[1], d[1]) + LazyFraction(n[2], d[2]) - LazyFraction(n[3], d[3]);
+        CHECK(lazy.getNumerator() == eager.getNumerator());
+        CHECK(lazy.getDenominator() == eager.getDenominator());
+        CHECK(Fraction(lazy) == eager);
+        CHECK(LazyFraction(eager) == lazy);
+        if (n[3] != 0) {
+            CHECK(Fraction(lazy / LazyFraction(n[3], d[3])) == eager / Fraction(n[3], d[3]));
+        }
+    }
+}
+
+TEST_CASE("Lazy reduction reduces before giving up on overflow") {
+    LazyFraction half(max_int - 1, 2 * (max_int / 2));
+    CHECK(half.getNumerator() == 1);
+    CHECK(half.getDenominator() == 1);
+    CHECK(half * LazyFraction(max_int, 3) == LazyFraction(max_int, 3));
+    CHECK(++LazyFraction(max_int - 1, max_int - 1) == LazyFraction(2));
+    CHECK(LazyFraction(min_int, -2 * (min_int / -4)) == LazyFraction(2));
+    CHECK(-LazyFraction(min_int, 2) == LazyFraction(1 << 30));
+
+    std::ostringstream out;
+    out << LazyFraction(6, -8);
+    CHECK(out.str() == "-3/4");
+    CHECK(LazyFraction(1, 3) < LazyFraction(2, 4));
+    CHECK_THROWS_AS(LazyFraction(max_int, 1) + LazyFraction(1, 1), std::overflow_error);
+}
+
+using SaturatingFraction = basic_fraction<int, eager_reduce, saturate_on_overflow>;
+using WrappingFraction = basic_fraction<int, eager_reduce, wrap_on_overflow>;
+using SaturatingFraction64 = basic_fraction<int64_t, lazy_reduce, saturate_on_overflow>;
+
+static_assert(sizeof(SaturatingFraction) == sizeof(Fraction) && std::is_trivially_copyable_v<WrappingFraction>);
+static_assert(SaturatingFraction(max_int, 1) + SaturatingFraction(1) == SaturatingFraction(max_int, 1));
+
+TEST_CASE("Best rational approximation with a bounded denominator") {
+    unsigned p = 0, q = 0;
+    bestApproximation(314159265U, 100000000U, 1000U, p, q);
+    CHECK((p == 355U && q == 113U));
+    bestApproximation(1U, 3U, 2U, p, q);
+    CHECK((p == 1U && q == 2U));
+    bestApproximation(0U, 7U, 2U, p, q);
+    CHECK((p == 0U && q == 1U));
+    bestApproximation(6U, 8U, 4U, p, q);
+    CHECK((p == 3U && q == 4U));
+
+    std::mt19937_64 gen(5);
+    for (int i = 0; i < 200; ++i) {
+        unsigned long long den = gen() % 100000 + 2, num = gen() % (3 * den), maxDen = gen() % 300 + 1;
+        unsigned long long bestNum = 0, bestDen = 0;
+        bestApproximation(num, den, maxDen, bestNum, bestDen);
+        REQUIRE(bestDen <= maxDen);
+        // |num/den - p/q| is |num*q - p*den| / (den*q); compare the errors without division.
+        auto error = [&](unsigned long long pp, unsigned long long qq) {
+            return num * qq > pp * den ? num * qq - pp * den : pp * den - num * qq;
+        };
+        bool closest = true;
+        for (unsigned long long qq = 1; qq <= maxDen; ++qq) {
+            unsigned long long pp = (2 * num * qq + den) / (2 * den);
+            closest = closest && error(bestNum, bestDen) * qq <= error(pp, qq) * bestDen;
+        }
+        CHECK(closest);
+    }
+}
+
+TEST_CASE("Overflow policies") {
+    CHECK_THROWS_AS(Fraction(max_int, 1) + Fraction(1), std::overflow_error);
+
+    SaturatingFraction big(max_int - 1, 1);
+    CHECK(big * SaturatingFraction(3) == SaturatingFraction(max_int, 1));
+    CHECK(-big * SaturatingFraction(3) == SaturatingFraction(-max_int, 1));
+    CHECK(SaturatingFraction(1, max_int) * SaturatingFraction(1, 3) == SaturatingFraction(0));
+    CHECK(SaturatingFraction(1, max_int) + SaturatingFraction(1, max_int - 1) == SaturatingFraction(1, max_int / 2));
+    SaturatingFraction x(1, 3);
+    x *= SaturatingFraction(max_int, max_int - 2);
+    CHECK(approx_equal(x, 1.0 / 3.0, 1e-9));
+    SaturatingFraction top(max_int, 1);
+    CHECK(++top == SaturatingFraction(max_int, 1));
+    CHECK(-SaturatingFraction(min_int, 1) == SaturatingFraction(max_int, 1));
+    CHECK_THROWS_AS(SaturatingFraction(1) / SaturatingFraction(0), std::overflow_error);
+
+    SaturatingFraction64 huge(fraction_traits<int64_t>::max, 1);
+    CHECK(huge + huge == huge);
+    CHECK((SaturatingFraction64(3, 4) + SaturatingFraction64(1, 4)).getNumerator() == 1);
+
+    wrap_on_overflow::clear();
+    WrappingFraction small(7, 9);
+    CHECK(small + WrappingFraction(2, 9) == WrappingFraction(1));
+    CHECK_FALSE(wrap_on_overflow::overflowed());
+    WrappingFraction wrapped = WrappingFraction(max_int, 1) + WrappingFraction(2);
+    CHECK(wrap_on_overflow::overflowed());
+    // max_int + 2 == 2^31 + 1, whose low 31 bits are 1.
+    CHECK(wrapped == WrappingFraction(1));
+    wrap_on_overflow::clear();
+    CHECK_FALSE(wrap_on_overflow::overflowed());
+}
+
+static_assert(Fraction::from_exact(0.75) == Fraction(3, 4));
+static_assert(Fraction::round_to_digits(2.421, 3) == Fraction(2421, 1000));
+
+TEST_CASE("Exact and digit-rounded conversions from floating point") {
+    CHECK(Fraction::from_exact(-2147483648.0) == Fraction(min_int, 1));
+    CHECK(Fraction::from_exact(1.0f / 1024) == Fraction(1, 1024));
+    CHECK(Fraction::from_exact(0.1f) == Fraction(13421773, 134217728));
+    CHECK(Fraction::from_exact(-0.0) == Fraction(0));
+    CHECK_FALSE(Fraction::checked_from_exact(0.1).has_value());
+    CHECK_FALSE(Fraction::checked_from_exact(2147483648.0).has_value());
+    CHECK_FALSE(Fraction::checked_from_exact(std::nan("")).has_value());
+    CHECK_THROWS_AS(Fraction::from_exact(1e300), std::overflow_error);
+    CHECK(Fraction64::from_exact(0.1) == Fraction64(3602879701896397, int64_t{1} << 55));
+    CHECK(Fraction128::from_exact(1e30) == Fraction128(static_cast<__int128>(1e30)));
+    CHECK(Fraction128::from_exact(std::ldexp(1.0, -126)).getDenominator() == static_cast<__int128>(1) << 126);
+    CHECK_FALSE(Fraction128::checked_from_exact(std::ldexp(1.0, -127)).has_value());
+
+    CHECK(Fraction::round_to_digits(0.1, 1) == Fraction(1, 10));
+    CHECK(Fraction::round_to_digits(2.5, 0) == Fraction(3));
+    CHECK(Fraction::round_to_digits(-2.5, 0) == Fraction(-3));
+    CHECK(Fraction::round_to_digits(2.4219, 3) == Fraction(2422, 1000));
+    CHECK(Fraction(2.4219) == Fraction(2421, 1000));
+    CHECK(Fraction::round_to_digits(1e-300, 9) == Fraction(0));
+    CHECK(Fraction::round_to_digits(3000000.25, 2) == Fraction(12000001, 4));
+    CHECK(Fraction::round_to_digits(0.3f, 3) == Fraction(3, 10));
+    CHECK_FALSE(Fraction::checked_round_to_digits(1.5, 10).has_value());
+    CHECK_FALSE(Fraction::checked_round_to_digits(1.5, -1).has_value());
+    CHECK_FALSE(Fraction::checked_round_to_digits(3e6, 3).has_value());
+    CHECK(Fraction64::round_to_digits(3.14159265358979, 15) == Fraction64(314159265358979, 100000000000000));
+    CHECK(Fraction128::round_to_digits(1e18, 19).getNumerator() == static_cast<__int128>(1e18));
+
+    std::mt19937_64 gen(13);
+    std::uniform_real_distribution<double> dist(-2000.0, 2000.0);
+    bool matchesRound = true, exactIsExact = true;
+    for (int i = 0; i < 2000; ++i) {
+        double x = dist(gen);
+        Fraction rounded = Fraction::round_to_digits(x, 3);
+        matchesRound = matchesRound && rounded == Fraction(static_cast<int>(std::llround(x * 1000)), 1000);
+        Fraction64 exact = Fraction64::from_exact(x);
+        exactIsExact = exactIsExact && static_cast<double>(exact.getNumerator()) ==
+                                       std::ldexp(x, std::countr_zero(static_cast<uint64_t>(exact.getDenominator())));
+    }
+    CHECK(matchesRound);
+    CHECK(exactIsExact);
+}
+
+static_assert(Fraction::from_double(3.141592653589793, 1000) == Fraction(355, 113));
+static_assert(Fraction(314159, 100000).limit_denominator(100) == Fraction(311, 99));
+
+TEST_CASE("Closest fraction with a bounded denominator") {
+    CHECK(Fraction::from_double(0.1, 10) == Fraction(1, 10));
+    CHECK(Fraction::from_double(-0.333333, 100) == Fraction(-1, 3));
+    CHECK(Fraction::from_double(2.0, 1) == Fraction(2));
+    CHECK(Fraction::from_double(0.0, 5) == Fraction(0));
+    CHECK(Fraction::from_double(0.4999, 1) == Fraction(0));
+    CHECK(Fraction::from_double(1e-300, max_int) == Fraction(0));
+    CHECK(Fraction::from_double(0.75, max_int) == Fraction(3, 4));
+    CHECK(Fraction64::from_double(0.1, int64_t{1} << 62) == Fraction64::from_exact(0.1));
+    Fraction128 tiny = Fraction128::from_double(1e-30, static_cast<__int128>(1) << 120);
+    CHECK(tiny.getDenominator() <= static_cast<__int128>(1) << 120);
+    // Below 2^-74 the input is first rounded to a multiple of 2^-127.
+    CHECK(std::fabs(static_cast<double>(tiny.getNumerator()) / static_cast<double>(tiny.getDenominator()) - 1e-30) <
+          std::ldexp(1.0, -127));
+    CHECK_FALSE(Fraction::checked_from_double(1e10, 7).has_value());
+    CHECK_FALSE(Fraction::checked_from_double(std::nan(""), 7).has_value());
+    CHECK_THROWS_AS(Fraction::from_double(0.5, 0), std::invalid_argument);
+    CHECK_THROWS_AS(Fraction::from_double(INFINITY, 10), std::overflow_error);
+
+    CHECK(Fraction(1, 3).limit_denominator(3) == Fraction(1, 3));
+    CHECK(Fraction(-7, 22).limit_denominator(10) == Fraction(-1, 3));
+    CHECK(Fraction(min_int, 3).limit_denominator(1) == Fraction(min_int / 3 - 1, 1));
+    CHECK(Fraction(min_int, 1).limit_denominator(1) == Fraction(min_int, 1));
+    CHECK(LazyFraction(6, 8).limit_denominator(4).getDenominator() == 4);
+    CHECK_THROWS_AS(Fraction(1, 2).limit_denominator(-1), std::invalid_argument);
+
+    std::vector<double> values{0.5, 0.3333333333, 3.14159265358979, -2.718281828};
+    std::vector<Fraction> out(values.size());
+    Fraction::from_double(values, out, 1000);
+    CHECK(out == std::vector<Fraction>{Fraction(1, 2), Fraction(1, 3), Fraction(355, 113), Fraction(-1457, 536)});
+    std::vector<Fraction> tooShort(2);
+    CHECK_THROWS_AS(Fraction::from_double(values, tooShort, 1000), std::invalid_argument);
+
+    // Agrees with a brute force search over every denominator.
+    std::mt19937_64 gen(17);
+    std::uniform_real_distribution<double> dist(-50.0, 50.0);
+    bool closest = true;
+    for (int i = 0; i < 300; ++i) {
+        double x = dist(gen);
+        int maxDen = static_cast<int>(gen() % 200) + 1;
+        Fraction best = Fraction::from_double(x, maxDen);
+        closest = closest && best.getDenominator() <= maxDen;
+        long double error = std::fabs(static_cast<long double>(best.getNumerator()) / best.getDenominator() - x);
+        for (int q = 1; q <= maxDen; ++q) {
+            long double p = std::nearbyint(static_cast<long double>(x) * q);
+            closest = closest && error <= std::fabs(p / q - x) * (1 + 1e-12L);
+        }
+    }
+    CHECK(closest);
+}
+
+TEST_CASE("Correctly rounded conversion to double and float") {
+    CHECK(Fraction(1, 3).to_double() == 1.0 / 3.0);
+    CHECK(double(Fraction(2, 3)) == 2.0 / 3.0);
+    CHECK(Fraction(1, 3).to_rounded_double() == 0.33333);
+    CHECK(Fraction(2, 3).to_rounded_double(2) == 0.67);
+    CHECK(Fraction(-1, 8).to_float() == -0.125f);
+    CHECK(float(Fraction(1, 3)) == 1.0f / 3.0f);
+
+    // The double quotient lands exactly on a float half way point the exact value is not on.
+    CHECK(Fraction(974422807, 792383487).to_float() == 1.2297364473342896f);
+    CHECK(Fraction(1402727654, 792383487).to_float() == 1.7702635526657104f);
+    CHECK(Fraction(-974678307, 676911323).to_float() == -1.439890742301941f);
+    CHECK(Fraction(1056055662, 676911323).to_float() == 1.560109257698059f);
+
+    // Parts wider than 53 bits take the long division path (expected values from Python's Fraction).
+    CHECK(Fraction64(7075566224961265392, 1752912918736228778).to_double() == 0x1.02556453df703p+2);
+    CHECK(Fraction64(7732188094977653328, 4313105013769917318).to_double() == 0x1.caefacbbfdd1ap+0);
+    CHECK(Fraction64(7692513687087629527, 8672664043982728007).to_double() == 0x1.c622c2282a948p-1);
+    CHECK(Fraction64(-6174256213954883011, 8763325800605239911).to_double() == -0x1.68bb99bd4895fp-1);
+    __int128 pow3 = 1;
+    for (int i = 0; i < 80; ++i) {
+        pow3 *= 3;
+    }
+    __int128 big = (static_cast<__int128>(1) << 126) + 12345;
+    CHECK(Fraction128(big, pow3).to_double() == 0x1.26adcc42519d5p-1);
+    CHECK(Fraction128(-big, pow3).to_double() == -0x1.26adcc42519d5p-1);
+    CHECK(Fraction128(fraction_traits<__int128>::max, fraction_traits<__int128>::max - 2).to_double() == 1.0);
+    CHECK(Fraction128(1, (static_cast<__int128>(1) << 126) + 1).to_double() == 0x1p-126);
+    CHECK(Fraction128(1, (static_cast<__int128>(1) << 126) + 1).to_float() == std::numeric_limits<float>::min());
+
+    std::vector<Fraction> fracs{Fraction(1, 3), Fraction(-5, 7), Fraction(max_int, 3)};
+    std::vector<double> doubles(fracs.size());
+    std::vector<float> floats(fracs.size());
+    Fraction::to_double(fracs, doubles);
+    Fraction::to_float(fracs, floats);
+    for (size_t i = 0; i < fracs.size(); ++i) {
+        CHECK(doubles[i] == fracs[i].to_double());
+        CHECK(floats[i] == fracs[i].to_float());
+    }
+    std::vector<double> tooShort(1);
+    CHECK_THROWS_AS(Fraction::to_double(fracs, tooShort), std::invalid_argument);
+
+    // Agrees with the long division path wherever the fast path is taken.
+    std::mt19937_64 gen(21);
+    bool agree = true;
+    for (int i = 0; i < 2000; ++i) {
+        auto num = static_cast<int64_t>(gen() >> (gen() % 64)) - static_cast<int64_t>(gen() >> (gen() % 64));
+        auto den = static_cast<int64_t>((gen() >> (1 + gen() % 63)) | 1U);
+        Fraction64 value(num, den);
+        double slow = quotientTo<double>(magnitude(value.getNumerator()), static_cast<uint64_t>(value.getDenominator()));
+        float slowFloat = quotientTo<float>(magnitude(value.getNumerator()), static_cast<uint64_t>(value.getDenominator()));
+        agree = agree && value.to_double() == (value.getNumerator() < 0 ? -slow : slow) &&
+                value.to_float() == (value.getNumerator() < 0 ? -slowFloat : slowFloat);
+    }
+    CHECK(agree);
+}
+
+static_assert(Fraction(1, 2) + 1 == Fraction(3, 2) && 1 - Fraction(1, 3) == Fraction(2, 3));
+static_assert(Fraction(3, 4) * 2 == Fraction(3, 2) && 3 / Fraction(3, 4) == 4);
+static_assert(Fraction(7, 2) > 3 && 4 > Fraction(7, 2) && Fraction(6, 3) == 2 && 2 == Fraction(4, 2));
+static_assert(narrower_integer<short, int> && !narrower_integer<long long, int> && narrower_integer<int, __int128>);
+
+TEST_CASE("Mixed fraction and integer operators") {
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<int> small(-1000, 1000), positive(1, 1000);
+    bool agree = true;
+    for (int i = 0; i < 500; ++i) {
+        Fraction a(small(gen), positive(gen));
+        int n = small(gen);
+        Fraction asFraction(n);
+        agree = agree && a + n == a + asFraction && n + a == asFraction + a;
+        agree = agree && a - n == a - asFraction && n - a == asFraction - a;
+        agree = agree && a * n == a * asFraction && n * a == asFraction * a;
+        if (n != 0) {
+            agree = agree && a / n == a / asFraction;
+        }
+        if (a != 0) {
+            agree = agree && n / a == asFraction / a;
+        }
+        agree = agree && (a <=> n) == (a <=> asFraction) && (n < a) == (asFraction < a) && (a == n) == (a == asFraction);
+        LazyFraction lazy(a.getNumerator() * 3, a.getDenominator() * 3);
+        agree = agree && Fraction(lazy * n) == a * n && Fraction(lazy / (n == 0 ? 1 : n)) == a / (n == 0 ? 1 : n);
+        agree = agree && (lazy == n) == (a == n);
+        Fraction128 wide(a.getNumerator(), a.getDenominator());
+        agree = agree && (wide <=> n) == (a <=> n) && (n >= wide) == (n >= a);
+    }
+    CHECK(agree);
+
+    CHECK(Fraction(1, 2) - short{1} == Fraction(-1, 2));
+    CHECK(Fraction64(1, 3) * 6 == 2);
+    CHECK(Fraction(max_int, 2) * 2 == max_int);
+    CHECK(-3 / Fraction(-3, 5) == 5);
+    CHECK(Fraction(3, 5) / -3 == Fraction(-1, 5));
+    CHECK(Fraction(0) / -3 == 0);
+    CHECK_THROWS_AS(Fraction(1, 2) / 0, std::overflow_error);
+    CHECK_THROWS_AS(1 / Fraction(0), std::overflow_error);
+    CHECK_THROWS_AS(Fraction(max_int, 1) + 1, std::overflow_error);
+    CHECK_THROWS_AS(min_int - Fraction(1, 2), std::overflow_error);
+    CHECK(basic_fraction<int, eager_reduce, saturate_on_overflow>(max_int, 1) + 1 == max_int);
+    // Wider integers still work through the checked converting constructor.
+    CHECK(Fraction(1, 2) + 1LL == Fraction(3, 2));
+    CHECK_THROWS_AS(Fraction(1, 2) + (1LL << 40), std::overflow_error);
+
+    // n * den overflows, but num + n * den fits.
+    CHECK(Fraction(-10, 3) + 715827884 == Fraction(2147483642, 3));
+    CHECK(715827884 - Fraction(10, 3) == Fraction(2147483642, 3));
+    CHECK(Fraction(10, 3) - 715827884 == Fraction(-2147483642, 3));
+    CHECK_THROWS_AS(Fraction(10, 3) + 715827884, std::overflow_error);
+    int64_t third64 = INT64_MAX / 3 + 1;
+    CHECK(Fraction64(-10, 3) + third64 == Fraction64(INT64_MAX - 8, 3));
+    CHECK(third64 - Fraction64(10, 3) == Fraction64(INT64_MAX - 8, 3));
+    CHECK(Fraction64(10, 3) - third64 == Fraction64(8 - INT64_MAX, 3));
+    __int128 third128 = fraction_traits<__int128>::max / 3 + 1;
+    CHECK(Fraction128(-10, 3) + third128 == Fraction128(fraction_traits<__int128>::max - 8, 3));
+    CHECK(third128 - Fraction128(10, 3) == Fraction128(fraction_traits<__int128>::max - 8, 3));
+    CHECK(Fraction128(10, 3) - third128 == Fraction128(8 - fraction_traits<__int128>::max, 3));
+    CHECK_THROWS_AS(Fraction128(10, 3) + third128, std::overflow_error);
+}
+
+TEST_CASE("Lazy integer operators reduce before giving up on overflow") {
+    // 3/4 scaled up to use more than 3/4 of the bits of int: every unreduced product overflows.
+    LazyFraction x(3 << 20, 4 << 20);
+    Fraction reduced(3, 4);
+    CHECK(Fraction(x + 1001) == reduced + 1001);
+    CHECK(Fraction(1001 + x) == 1001 + reduced);
+    CHECK(Fraction(x - 1001) == reduced - 1001);
+    CHECK(Fraction(1001 - x) == 1001 - reduced);
+    CHECK(Fraction(x * 1001) == reduced * 1001);
+    CHECK(Fraction(1001 * x) == 1001 * reduced);
+    CHECK(Fraction(x / 1001) == reduced / 1001);
+    CHECK(Fraction(1001 / x) == 1001 / reduced);
+    CHECK(Fraction(x / -1001) == reduced / -1001);
+    CHECK(Fraction(-1001 / x) == -1001 / reduced);
+    CHECK_THROWS_AS(LazyFraction(max_int - 1, 1) + 2, std::overflow_error);
+}
+
+TEST_CASE("Parsing fractions with from_chars() and parse()") {
+    CHECK(Fraction::parse("5/6") == Fraction(5, 6));
+    CHECK(Fraction::parse("5 6") == Fraction(5, 6));
+    CHECK(Fraction::parse("-4/6") == Fraction(-2, 3));
+    CHECK(Fraction::parse("3\t -4") == Fraction(-3, 4));
+    CHECK(Fraction::parse("42") == 42);
+    CHECK(Fraction::parse("-2147483648") == min_int);
+    CHECK(Fraction128::parse("-170141183460469231731687303715884105728/3")->getNumerator() ==
+          fraction_traits<__int128>::min);
+    CHECK_FALSE(Fraction::parse(""));
+    CHECK_FALSE(Fraction::parse("5/"));
+    CHECK_FALSE(Fraction::parse("5 6 7"));
+    CHECK_FALSE(Fraction::parse("+5"));
+    CHECK_FALSE(Fraction::parse("3.5"));
+    CHECK_FALSE(Fraction::parse("1/0"));
+    CHECK_FALSE(Fraction::parse("2147483648"));
+    CHECK_FALSE(Fraction::parse("-2147483648/-1"));
+    CHECK_FALSE(Fraction128::parse("170141183460469231731687303715884105728"));
+
+    const char text[] = "7/8 9 -10 11 x 12/0";
+    Fraction value;
+    auto result = from_chars(std::begin(text), std::end(text) - 1, value);
+    CHECK((result.ec == std::errc{} && result.ptr == text + 3 && value == Fraction(7, 8)));
+    result = from_chars(result.ptr + 1, std::end(text) - 1, value);
+    CHECK((result.ec == std::errc{} && result.ptr == text + 9 && value == Fraction(-9, 10)));
+    // Blanks not followed by a number end a plain integer.
+    result = from_chars(result.ptr + 1, std::end(text) - 1, value);
+    CHECK((result.ec == std::errc{} && result.ptr == text + 12 && value == 11));
+    result = from_chars(result.ptr + 3, std::end(text) - 1, value);
+    CHECK((result.ec == std::errc::argument_out_of_domain && value == 11));
+    result = from_chars(text + 13, std::end(text) - 1, value);
+    CHECK((result.ec == std::errc::invalid_argument && result.ptr == text + 13));
+    result = from_chars(text, text, value);
+    CHECK(result.ec == std::errc::invalid_argument);
+
+    std::mt19937_64 gen(29);
+    bool agree = true;
+    for (int i = 0; i < 1000; ++i) {
+        auto num = static_cast<int64_t>(gen());
+        auto den = static_cast<int64_t>(gen() >> 1U) | 1;
+        Fraction64 expected(num, den);
+        Fraction128 wide(static_cast<__int128>(num) * den, static_cast<__int128>(den) * den);
+        agree = agree && Fraction64::parse(std::to_string(num) + "/" + std::to_string(den)) == expected;
+        std::ostringstream out;
+        out << wide;
+        agree = agree && Fraction128::parse(out.str()) == wide;
+    }
+    CHECK(agree);
+}
+
+TEST_CASE("operator>> reads through from_chars()") {
+    std::istringstream input("1/2 -3   4\n5\n-6 7/0");
+    Fraction a, b, c;
+    input >> a >> b >> c;
+    CHECK((a == Fraction(1, 2) && b == Fraction(-3, 4) && c == Fraction(-5, 6)));
+    CHECK_THROWS_AS(input >> a, std::runtime_error);
+    CHECK(input.fail());
+    CHECK(a == Fraction(1, 2));
+
+    std::istringstream lone("7");
+    CHECK_THROWS_AS(lone >> a, std::runtime_error);
+    std::istringstream slash("7/ 8");
+    CHECK_THROWS_AS(slash >> a, std::runtime_error);
+
+    // No seeking, so a plain stream buffer without positioning works too.
+    struct ForwardOnly : std::stringbuf {
+        using std::stringbuf::stringbuf;
+        pos_type seekoff(off_type, std::ios::seekdir, std::ios::openmode) override { return pos_type(off_type(-1)); }
+        pos_type seekpos(pos_type, std::ios::openmode) override { return pos_type(off_type(-1)); }
+    } pipe("-170141183460469231731687303715884105728 1 x");
+    std::istream piped(&pipe);
+    Fraction128 wide;
+    piped >> wide;
+    CHECK(wide == Fraction128(fraction_traits<__int128>::min, 1));
+    CHECK_THROWS_AS(piped >> wide, std::runtime_error);
+}
+
+TEST_CASE("Formatting fractions with to_chars()") {
+    auto format = [](auto value, fraction_format style = fraction_format::fraction, int precision = 0) {
+        char text[128];
+        auto result = to_chars(std::begin(text), std::end(text), value, style, precision);
+        return result.ec == std::errc{} ? std::string(text, result.ptr) : std::string("error");
+    };
+    CHECK(format(Fraction(6, -4)) == "-3/2");
+    CHECK(format(Fraction(0)) == "0/1");
+    CHECK(format(LazyFraction(6, 4) + LazyFraction(1, 2)) == "2/1");
+    CHECK(format(Fraction128(fraction_traits<__int128>::min, 3)) == "-170141183460469231731687303715884105728/3");
+    CHECK(format(Fraction(7, 3), fraction_format::mixed) == "2 1/3");
+    CHECK(format(Fraction(-7, 3), fraction_format::mixed) == "-2 1/3");
+    CHECK(format(Fraction(-1, 2), fraction_format::mixed) == "-1/2");
+    CHECK(format(Fraction(-4), fraction_format::mixed) == "-4");
+    CHECK(format(Fraction(0), fraction_format::mixed) == "0");
+    CHECK(format(Fraction(2, 3), fraction_format::decimal, 3) == "0.667");
+    CHECK(format(Fraction(-1, 1000), fraction_format::decimal, 2) == "-0.00");
+    CHECK(format(Fraction(999, 1000), fraction_format::decimal, 2) == "1.00");
+    CHECK(format(Fraction(-19999, 2000), fraction_format::decimal, 3) == "-10.000");
+    // Exact ties round to even.
+    CHECK(format(Fraction(5, 2), fraction_format::decimal, 0) == "2");
+    CHECK(format(Fraction(7, 2), fraction_format::decimal, 0) == "4");
+    CHECK(format(Fraction(1, 8), fraction_format::decimal, 2) == "0.12");
+    CHECK(format(Fraction(3, 8), fraction_format::decimal, 2) == "0.38");
+    CHECK(format(Fraction128(1, fraction_traits<__int128>::max), fraction_format::decimal, 40) ==
+          "0.0000000000000000000000000000000000000059");
+
+    char small[4];
+    auto result = to_chars(std::begin(small), std::end(small), Fraction(12, 5));
+    CHECK((result.ec == std::errc{} && std::string(small, result.ptr) == "12/5"));
+    result = to_chars(std::begin(small), std::end(small), Fraction(-12, 5));
+    CHECK((result.ec == std::errc::value_too_large && result.ptr == std::end(small)));
+    result = to_chars(std::begin(small), std::end(small), Fraction(99, 100), fraction_format::decimal, 1);
+    CHECK((result.ec == std::errc{} && std::string(small, result.ptr) == "1.0"));
+    result = to_chars(std::begin(small), std::end(small), Fraction(-199, 20), fraction_format::decimal, 1);
+    CHECK(result.ec == std::errc::value_too_large);
+    result = to_chars(std::begin(small), std::end(small), Fraction(1, 3), fraction_format::decimal, -1);
+    CHECK(result.ec == std::errc::invalid_argument);
+
+    // The printed decimal D / 10^p is within half a unit of the value, and even on a tie.
+    std::mt19937_64 gen(31);
+    bool rounded = true, roundTrip = true;
+    for (int i = 0; i < 2000; ++i) {
+        auto num = static_cast<int64_t>(gen() >> (1 + gen() % 63)) * (gen() % 2 == 0 ? 1 : -1);
+        auto den = static_cast<int64_t>(gen() >> (1 + gen() % 63)) | 1;
+        Fraction64 value(num, den);
+        int precision = static_cast<int>(gen() % 16);
+        std::string text = format(value, fraction_format::decimal, precision);
+        text.erase(std::remove(text.begin(), text.end(), '.'), text.end());
+        __int128 digits = Fraction128::parse(text)->getNumerator(), scale = 1;
+        for (int k = 0; k < precision; ++k) {
+            scale *= 10;
+        }
+        __int128 error = static_cast<__int128>(value.getNumerator()) * scale - digits * value.getDenominator();
+        __int128 twice = 2 * (error < 0 ? -error : error);
+        rounded = rounded && (twice < value.getDenominator() || (twice == value.getDenominator() && digits % 2 == 0));
+        roundTrip = roundTrip && Fraction64::parse(format(value)) == value;
+    }
+    CHECK(rounded);
+    CHECK(roundTrip);
+}
+
+TEST_CASE("std::format() specs for fractions") {
+    auto format = [](std::string_view text, auto value) {
+        fraction_format_spec spec;
+        auto parsed = spec.parse(text.data(), text.data() + text.size());
+        if (parsed.ec != std::errc{}) {
+            return std::string("error");
+        }
+        std::string out;
+        spec.format(std::back_inserter(out), value);
+        return out;
+    };
+    CHECK(format("", Fraction(-6, 4)) == "-3/2");
+    CHECK(format("}", Fraction(6, 4)) == "3/2");
+    CHECK(format("m}", Fraction(-7, 3)) == "-2 1/3");
+    CHECK(format("f}", Fraction(2, 3)) == "0.666667");
+    CHECK(format(".2f}", Fraction(-1, 8)) == "-0.12");
+    CHECK(format(".0f", Fraction(7, 2)) == "4");
+    CHECK(format(".256f", Fraction128(1, 3)) == "0." + std::string(256, '3'));
+    CHECK(format(".256f", Fraction128(fraction_traits<__int128>::min, 1)) ==
+          "-170141183460469231731687303715884105728." + std::string(256, '0'));
+    CHECK(format("m", Fraction64(fraction_traits<int64_t>::min + 1, fraction_traits<int64_t>::max)) ==
+          "-1");
+
+    fraction_format_spec spec;
+    std::string_view bad = ".257f}";
+    auto parsed = spec.parse(bad.data(), bad.data() + bad.size());
+    CHECK((parsed.ec == std::errc::value_too_large && parsed.ptr == bad.data() + 3));
+    bad = ".3}";
+    parsed = spec.parse(bad.data(), bad.data() + bad.size());
+    CHECK((parsed.ec == std::errc::invalid_argument && parsed.ptr == bad.data() + 2));
+    bad = "x}";
+    parsed = spec.parse(bad.data(), bad.data() + bad.size());
+    CHECK((parsed.ec == std::errc::invalid_argument && parsed.ptr == bad.data()));
+    bad = ".1m}";
+    parsed = spec.parse(bad.data(), bad.data() + bad.size());
+    CHECK(parsed.ec == std::errc::invalid_argument);
+    // std::formatter::parse() runs at compile time, so the spec parser has to as well.
+    static_assert([] {
+        fraction_format_spec constant;
+        std::string_view text = ".12f}";
+        return constant.parse(text.data(), text.data() + text.size()).ec == std::errc{} &&
+               constant.style == fraction_format::decimal && constant.precision == 12;
+    }());
+}
+
+TEST_CASE("operator<< writes through to_chars()") {
+    std::ostringstream out;
+    out << Fraction(-3, 6) << ' ' << Fraction128(fraction_traits<__int128>::max, 2) << ' ' << LazyFraction(4, 8);
+    CHECK(out.str() == "-1/2 170141183460469231731687303715884105727/2 1/2");
+}
+
+TEST_CASE("Parsing decimal and mixed-number text") {
+    auto decimal = [](std::string_view text) { return Fraction64::parse(text, fraction_format::decimal); };
+    CHECK(decimal("3.14159") == Fraction64(314159, 100000));
+    CHECK(decimal("-12.5") == Fraction64(-25, 2));
+    CHECK(decimal(".5") == Fraction64(1, 2));
+    CHECK(decimal("5.") == 5);
+    CHECK(decimal("-0.0") == 0);
+    CHECK(decimal("1e-7") == Fraction64(1, 10000000));
+    CHECK(decimal("2.5E+3") == 2500);
+    CHECK(decimal("0.(3)") == Fraction64(1, 3));
+    CHECK(decimal("-0.1(6)") == Fraction64(-1, 6));
+    CHECK(decimal("0.(142857)") == Fraction64(1, 7));
+    CHECK(decimal("0.(9)") == 1);
+    CHECK(decimal("1.2(30)e2") == Fraction64(4060, 33));
+    CHECK(decimal("0.(3)e-1") == Fraction64(1, 30));
+    // Zeros beyond the range of the digits still parse when the value fits.
+    CHECK(decimal("1.5000000000000000000000000000000000000000000") == Fraction64(3, 2));
+    CHECK(decimal("15000000000000000000000000000000000000000000e-43") == Fraction64(3, 2));
+    CHECK(decimal("0.000000000000000000000000000000000000000000000001e48") == 1);
+    CHECK(decimal("7450580596923828125e-27") == Fraction64(1, 134217728));
+    CHECK(decimal("9223372036854775807") == fraction_traits<int64_t>::max);
+    CHECK(decimal("-9223372036854775808") == fraction_traits<int64_t>::min);
+    CHECK(decimal("0e999999999") == 0);
+    CHECK_FALSE(decimal("9223372036854775808"));
+    CHECK_FALSE(decimal("1e19"));
+    CHECK_FALSE(decimal("1e-19"));
+    CHECK_FALSE(decimal("0.(3"));
+    CHECK_FALSE(decimal("1.5e"));
+    CHECK_FALSE(decimal("."));
+    CHECK_FALSE(decimal("+1"));
+    CHECK_FALSE(decimal("(3)"));
+    CHECK(Fraction128::parse("1e-38", fraction_format::decimal) ==
+          Fraction128(1, static_cast<__int128>(10000000000000000000ULL) * 10000000000000000000ULL));
+    CHECK(decimal("0.0(0000000001)") == Fraction64(1, 99999999990));
+    CHECK_FALSE(Fraction::parse("0.0(0000000001)", fraction_format::decimal));
+
+    Fraction value(1, 2);
+    const char text[] = "3.25e1x 0.(3 1.5e+ 1e99";
+    auto result = from_chars(text, std::end(text) - 1, value, fraction_format::decimal);
+    CHECK((result.ec == std::errc{} && result.ptr == text + 6 && value == Fraction(65, 2)));
+    result = from_chars(text + 8, std::end(text) - 1, value, fraction_format::decimal);
+    CHECK((result.ec == std::errc{} && result.ptr == text + 10 && value == 0));
+    result = from_chars(text + 13, std::end(text) - 1, value, fraction_format::decimal);
+    CHECK((result.ec == std::errc{} && result.ptr == text + 16 && value == Fraction(3, 2)));
+    result = from_chars(text + 19, std::end(text) - 1, value, fraction_format::decimal);
+    CHECK((result.ec == std::errc::result_out_of_range && result.ptr == std::end(text) - 1 && value == Fraction(3, 2)));
+
+    // Every double has a finite decimal expansion; its 17 significant digits parse to the same
+    // fraction as reading those digits back through from_exact().
+    std::mt19937_64 gen(37);
+    bool agree = true;
+    for (int i = 0; i < 1000; ++i) {
+        char digits[32];
+        double x = std::ldexp(static_cast<double>(gen() >> 11U), -static_cast<int>(gen() % 40));
+        auto printed = std::to_chars(std::begin(digits), std::end(digits), x, std::chars_format::scientific, 16);
+        auto parsed = Fraction128::parse(std::string_view(digits, static_cast<size_t>(printed.ptr - digits)),
+                                         fraction_format::decimal);
+        agree = agree && parsed && parsed->to_double() == x;
+    }
+    CHECK(agree);
+
+    auto mixed = [](std::string_view input) { return Fraction::parse(input, fraction_format::mixed); };
+    CHECK(mixed("2 1/3") == Fraction(7, 3));
+    CHECK(mixed("-2 1/3") == Fraction(-7, 3));
+    CHECK(mixed("-1/2") == Fraction(-1, 2));
+    CHECK(mixed("4") == 4);
+    CHECK(mixed("1\t6/4") == Fraction(5, 2));
+    CHECK_FALSE(mixed("1 2"));
+    CHECK_FALSE(mixed("1 -1/2"));
+    CHECK_FALSE(mixed("1 1/0"));
+    CHECK_FALSE(mixed("2147483647 1/2"));
+    CHECK(mixed("-2147483647 1/1") == min_int);
+    bool roundTrip = true;
+    for (int i = 0; i < 1000; ++i) {
+        Fraction64 x(static_cast<int64_t>(gen() >> (1 + gen() % 63)) * (gen() % 2 == 0 ? 1 : -1),
+                     static_cast<int64_t>(gen() >> (1 + gen() % 63)) | 1);
+        char buffer[64];
+        auto written = to_chars(std::begin(buffer), std::end(buffer), x, fraction_format::mixed, 0);
+        roundTrip = roundTrip && Fraction64::parse(std::string_view(buffer, static_cast<size_t>(written.ptr - buffer)),
+                                                   fraction_format::mixed) == x;
+    }
+    CHECK(roundTrip);
+}
+
+TEST_CASE("Decimal expansion with to_decimal()") {
+    CHECK(to_decimal(Fraction(1, 3), 5) == "0.33333");
+    CHECK(to_decimal(Fraction(2, 3), 5) == "0.66667");
+    CHECK(to_decimal(Fraction(2, 3), 0) == "1");
+    CHECK(to_decimal(Fraction(1, 8), 10) == "0.125");
+    CHECK(to_decimal(Fraction(-7, 2), 3) == "-3.5");
+    CHECK(to_decimal(Fraction(-1, 1000), 2) == "0");
+    CHECK(to_decimal(Fraction(1, 3), 5, true) == "0.(3)");
+    CHECK(to_decimal(Fraction(1, 6), 5, true) == "0.1(6)");
+    CHECK(to_decimal(Fraction(-5, 12), 5, true) == "-0.41(6)");
+    CHECK(to_decimal(Fraction(22, 7), 6, true) == "3.(142857)");
+    CHECK(to_decimal(Fraction(1, 7), 5, true) == "0.14286");
+    CHECK(to_decimal(Fraction(1, 8), 10, true) == "0.125");
+    CHECK(to_decimal(Fraction(4), 10, true) == "4");
+    CHECK(to_decimal(Fraction128(1, fraction_traits<__int128>::max), 40) ==
+          "0.0000000000000000000000000000000000000059");
+    CHECK_THROWS_AS(to_decimal(Fraction(1, 3), -1), std::invalid_argument);
+
+    Fraction128 tiny(1, static_cast<__int128>(3) << 40U);
+    std::string expansion = to_decimal(tiny, 60, true);
+    CHECK(expansion.ends_with("(3)"));
+    CHECK(Fraction128::parse(expansion, fraction_format::decimal) == tiny);
+    // A 127-bit prime modulus: 10 has a huge order, so no block fits.
+    CHECK(to_decimal(Fraction128(1, fraction_traits<__int128>::max), 50, true).size() == 52);
+
+    std::mt19937_64 gen(41);
+    bool roundTrip = true, matchesToChars = true;
+    for (int i = 0; i < 1000; ++i) {
+        // Periods up to 18 digits keep the text within what parse() can read back.
+        Fraction64 x(static_cast<int64_t>(gen() % 2000001) - 1000000, static_cast<int64_t>(gen() % 20 + 1));
+        std::string exact = to_decimal(x, 30, true);
+        roundTrip = roundTrip && Fraction64::parse(exact, fraction_format::decimal) == x;
+        Fraction64 wide(static_cast<int64_t>(gen() >> 1U), static_cast<int64_t>(gen() >> 1U) | 1);
+        char text[128];
+        auto result = to_chars(std::begin(text), std::end(text), wide, fraction_format::decimal, 60);
+        std::string rounded = to_decimal(wide, 60);
+        matchesToChars = matchesToChars && std::string_view(text, static_cast<size_t>(result.ptr - text))
+                .starts_with(rounded);
+    }
+    CHECK(roundTrip);
+    CHECK(matchesToChars);
+}
+
+TEST_CASE("BigInt arithmetic") {
+    std::mt19937_64 gen(43);
+    auto random128 = [&gen]() {
+        return static_cast<__int128>((static_cast<unsigned __int128>(gen()) << 64U | gen()) >> (gen() % 126 + 2));
+    };
+    bool matches = true;
+    for (int i = 0; i < 2000; ++i) {
+        __int128 a = random128() * (gen() % 2 ? 1 : -1), b = random128() * (gen() % 2 ? 1 : -1);
+        __int128 halfA = a >> 1, halfB = b >> 1; // keeps the sum and difference in range
+        matches = matches && (BigInt(halfA) + BigInt(halfB)).to_int<__int128>() == halfA + halfB;
+        matches = matches && (BigInt(halfA) - BigInt(halfB)).to_int<__int128>() == halfA - halfB;
+        matches = matches && (BigInt(a >> 64) * BigInt(b >> 64)).to_int<__int128>() == (a >> 64) * (b >> 64);
+        matches = matches && (BigInt(a) <=> BigInt(b)) == (a <=> b);
+        if (b != 0) {
+            matches = matches && (BigInt(a) / BigInt(b)).to_int<__int128>() == a / b;
+            matches = matches && (BigInt(a) % BigInt(b)).to_int<__int128>() == a % b;
+        }
+    }
+    CHECK(matches);
+
+    // Multi-limb values: divmod, gcd and the decimal text agree with each other.
+    auto randomBig = [&gen](size_t limbs) {
+        BigInt value = 1;
+        for (size_t i = 0; i < limbs; ++i) {
+            value = (value << 64U) + BigInt(static_cast<__int128>(gen()));
+        }
+        return gen() % 2 ? -value : value;
+    };
+    bool identities = true;
+    for (int i = 0; i < 200; ++i) {
+        BigInt a = randomBig(gen() % 12 + 1), b = randomBig(gen() % 6 + 1), c = randomBig(gen() % 4 + 1);
+        auto [quotient, remainder] = BigInt::divmod(a, b);
+        identities = identities && quotient * b + remainder == a && remainder.abs() < b.abs();
+        identities = identities && (remainder.is_zero() || remainder.is_negative() == a.is_negative());
+        identities = identities && BigInt::divexact(a * b, b) == a;
+        // Even divisors, whose shared power of two exact division strips first.
+        BigInt even = b << (gen() % 200);
+        identities = identities && BigInt::divexact(a * even, even) == a && BigInt::divexact(a * even, a) == even;
+        BigInt g = gcd(a * c, b * c);
+        identities = identities && (a * c) % g == 0 && (b * c) % g == 0 && g % c.abs() == 0;
+        identities = identities && gcd(BigInt::divexact(a * c, g), BigInt::divexact(b * c, g)) == 1;
+        BigInt parsed;
+        std::string text = a.to_string();
+        identities = identities && from_chars(text.data(), text.data() + text.size(), parsed).ec == std::errc{};
+        identities = identities && parsed == a;
+    }
+    CHECK(identities);
+
+    BigInt power = 1;
+    for (int i = 0; i < 40; ++i) {
+        power *= 10;
+    }
+    CHECK(power.to_string() == "10000000000000000000000000000000000000000");
+    CHECK((-power + 1).to_string() == "-9999999999999999999999999999999999999999");
+    CHECK((power >> 40U).to_string() == "9094947017729282379150390625"); // 5^40
+    CHECK(power.trailing_zeros() == 40);
+    CHECK(BigInt().to_string() == "0");
+    __int128 narrow = 0;
+    CHECK_FALSE(power.fits(narrow));
+    CHECK(BigInt(fraction_traits<__int128>::min).fits(narrow));
+    CHECK(narrow == fraction_traits<__int128>::min);
+    CHECK_THROWS_AS(power.to_int<int64_t>(), std::overflow_error);
+    CHECK_THROWS_AS(power / BigInt(), std::overflow_error);
+    CHECK(BigInt::divexact(power, BigInt(1) << 40U) == power >> 40U);
+    CHECK(BigInt::divexact(-power, power) == -1);
+    CHECK(BigInt::divexact(BigInt(), power).is_zero());
+    CHECK_THROWS_AS(BigInt::divexact(power, BigInt()), std::overflow_error);
+}
+
+TEST_CASE("BigFraction arithmetic and conversions") {
+    BigFraction harmonic;
+    for (int i = 1; i <= 100; ++i) {
+        harmonic += BigFraction(1, i);
+    }
+    CHECK(harmonic.to_string() ==
+          "14466636279520351160221518043104131447711/2788815009188499086581352357412492142272");
+    BigFraction power = 1;
+    for (int i = 0; i < 50; ++i) {
+        power *= BigFraction(7, 3);
+    }
+    CHECK(power.to_string() == "1798465042647412146620280340569649349251249/717897987691852588770249");
+    for (int i = 0; i < 50; ++i) {
+        power /= BigFraction(-7, 3);
+    }
+    CHECK(power == 1);
+
+    CHECK(BigFraction(2, -4).to_string() == "-1/2");
+    CHECK(BigFraction(0, -4).to_string() == "0/1");
+    CHECK(BigFraction(1, 2) - BigFraction(1, 2) == 0);
+    CHECK(BigFraction(1, 6) + BigFraction(1, 3) == BigFraction(1, 2));
+    CHECK(BigFraction(-1, 3) < BigFraction(-1, 4));
+    CHECK(BigFraction(5, 3) > 1);
+    CHECK(BigFraction(Fraction(3, 4)) == BigFraction(3, 4));
+    CHECK(BigFraction(3, 4).to_fraction() == Fraction(3, 4));
+    CHECK(harmonic.checked_to_fraction() == std::nullopt);
+    CHECK_THROWS_AS(harmonic.to_fraction<Fraction128>(), std::overflow_error);
+    CHECK(BigFraction(Fraction128(fraction_traits<__int128>::max, 3)).to_fraction<Fraction128>() ==
+          Fraction128(fraction_traits<__int128>::max, 3));
+    CHECK_THROWS_AS(BigFraction(1, 0), std::invalid_argument);
+    CHECK_THROWS_AS(harmonic / BigFraction(), std::overflow_error);
+
+    // Agrees with Fraction128 wherever that does not overflow.
+    std::mt19937_64 gen(47);
+    bool matches = true;
+    for (int i = 0; i < 2000; ++i) {
+        Fraction64 x(static_cast<int64_t>(gen() % 200001) - 100000, static_cast<int64_t>(gen() % 1000 + 1));
+        Fraction64 y(static_cast<int64_t>(gen() % 200001) - 100000, static_cast<int64_t>(gen() % 1000 + 1));
+        BigFraction bx = x, by = y;
+        matches = matches && (bx + by).to_fraction<Fraction64>() == x + y;
+        matches = matches && (bx - by).to_fraction<Fraction64>() == x - y;
+        matches = matches && (bx * by).to_fraction<Fraction64>() == x * y;
+        matches = matches && (y == 0 || (bx / by).to_fraction<Fraction64>() == x / y);
+        matches = matches && (bx <=> by) == (x <=> y);
+    }
+    CHECK(matches);
+
+    std::istringstream input("14466636279520351160221518043104131447711/2788815009188499086581352357412492142272 "
+                             "-6 4  7");
+    BigFraction a, b;
+    input >> a >> b;
+    CHECK(a == harmonic);
+    CHECK(b == BigFraction(-3, 2));
+    CHECK_THROWS_AS(input >> a, std::runtime_error);
+    std::istringstream zero("1/0");
+    CHECK_THROWS_AS(zero >> a, std::runtime_error);
+    std::ostringstream output;
+    output << harmonic << ' ' << BigFraction(-3, 2);
+    CHECK(output.str() == harmonic.to_string() + " -3/2");
+    CHECK(BigFraction::parse("10/-4") == BigFraction(-5, 2));
+    CHECK(BigFraction::parse("12") == 12);
+    CHECK(BigFraction::parse("1/0") == std::nullopt);
+    CHECK(BigFraction::parse("1/2x") == std::nullopt);
+}
+
+TEST_CASE("HybridFraction promotes on overflow and demotes when the value fits") {
+    constexpr int64_t max64 = fraction_traits<int64_t>::max, min64 = fraction_traits<int64_t>::min;
+    HybridFraction third(max64, 3), small(1, 3);
+    CHECK(third.is_small());
+    HybridFraction sum = third + small;
+    CHECK_FALSE(sum.is_small());
+    CHECK(sum.to_big() == BigFraction(max64, 3) + BigFraction(1, 3));
+    CHECK_THROWS_AS(sum.to_fraction(), std::overflow_error);
+    sum += small;
+    CHECK(sum.is_small()); // (2^63 + 1) / 3 is whole and fits again
+    CHECK(sum.to_fraction() == Fraction64(3074457345618258603LL, 1));
+    CHECK((sum - small - small) == third);
+
+    HybridFraction product = HybridFraction(max64, 3) * HybridFraction(max64, 5) / HybridFraction(max64, 7);
+    std::ostringstream output;
+    output << product << ' ' << HybridFraction(2, -4);
+    CHECK(output.str() == "64563604257983430649/15 -1/2");
+    CHECK_FALSE(product.is_small());
+    CHECK(product / product == 1);
+    CHECK((product / product).is_small());
+
+    HybridFraction lowest(min64, -1);
+    CHECK_FALSE(lowest.is_small());
+    CHECK(-lowest == HybridFraction(min64));
+    CHECK((-lowest).is_small());
+    CHECK(-HybridFraction(min64) == lowest);
+    CHECK(HybridFraction(static_cast<__int128>(max64) + 1) == lowest);
+    CHECK(HybridFraction(min64, 2).to_fraction() == Fraction64(min64 / 2, 1));
+    CHECK(lowest > HybridFraction(max64));
+    CHECK(HybridFraction(max64) < lowest);
+    CHECK(--HybridFraction(lowest) == HybridFraction(max64));
+    CHECK(++HybridFraction(max64) == lowest);
+
+    HybridFraction harmonic;
+    for (int i = 1; i <= 60; ++i) {
+        harmonic += HybridFraction(1, i);
+    }
+    CHECK(harmonic.getNumerator().to_string() == "15117092380124150817026911");
+    CHECK(harmonic.getDenominator().to_string() == "3230237388259077233637600");
+    HybridFraction copy = harmonic;
+    for (int i = 60; i >= 1; --i) {
+        copy -= HybridFraction(1, i);
+    }
+    CHECK(copy == 0);
+    CHECK(copy.is_small());
+    CHECK_FALSE(harmonic.is_small());
+
+    CHECK_THROWS_AS(HybridFraction(1, 0), std::invalid_argument);
+    CHECK_THROWS_AS(harmonic / HybridFraction(), std::overflow_error);
+    CHECK_THROWS_AS(third / HybridFraction(), std::overflow_error);
+
+    std::istringstream input("36893488147419103232/3 5 10");
+    HybridFraction a, b;
+    input >> a >> b;
+    CHECK_FALSE(a.is_small());
+    CHECK(a * 3 == HybridFraction(static_cast<__int128>(1) << 65U));
+    CHECK(b == HybridFraction(1, 2));
+    CHECK(b.is_small());
+
+    // Agrees with Fraction64 while that does not overflow, and with BigFraction when it does.
+    std::mt19937_64 gen(53);
+    bool matches = true;
+    for (int i = 0; i < 2000; ++i) {
+        Fraction64 x(static_cast<int64_t>(gen()) >> (gen() % 63), static_cast<int64_t>(gen() >> (gen() % 63 + 1)) | 1);
+        Fraction64 y(static_cast<int64_t>(gen()) >> (gen() % 63) | 1, static_cast<int64_t>(gen() >> (gen() % 63 + 1)) | 1);
+        HybridFraction hx = x, hy = y;
+        BigFraction bx = x, by = y;
+        for (char op: {'+', '-', '*', '/'}) {
+            optional<Fraction64> narrow = op == '+' ? checked_add(x, y) : op == '-' ? checked_sub(x, y)
+                    : op == '*' ? checked_mul(x, y) : checked_div(x, y);
+            HybridFraction result = op == '+' ? hx + hy : op == '-' ? hx - hy : op == '*' ? hx * hy : hx / hy;
+            BigFraction exact = op == '+' ? bx + by : op == '-' ? bx - by : op == '*' ? bx * by : bx / by;
+            matches = matches && result.to_big() == exact && result.is_small() == narrow.has_value();
+            matches = matches && (!narrow || result.to_fraction() == *narrow);
+        }
+        matches = matches && (hx <=> hy) == (x <=> y);
+    }
+    CHECK(matches);
+}
+
+TEST_CASE("BigInt multiplication algorithms agree with schoolbook") {
+    constexpr size_t never = ~size_t(0);
+    std::mt19937_64 gen(59);
+    auto randomBig = [&gen](size_t limbs) {
+        BigInt value;
+        for (size_t i = 0; i < limbs; ++i) {
+            // Some all-ones and zero limbs exercise the carries and borrows.
+            uint64_t part = gen() % 4 == 0 ? (gen() % 2 == 0 ? ~uint64_t(0) : 0) : gen();
+            value = (value << 64U) + BigInt(static_cast<__int128>(part));
+        }
+        return value;
+    };
+    bool matches = true, squares = true;
+    for (int i = 0; i < 300; ++i) {
+        BigInt a = randomBig(gen() % 120 + 1), b = gen() % 4 == 0 ? a : -randomBig(gen() % 120 + 1);
+        BigInt product, square;
+        {
+            BigInt::tuning_override schoolbook({never, never, never, never});
+            product = a * b;
+            square = a * a;
+        }
+        // Small thresholds so every algorithm and the unbalanced split recurse several levels.
+        BigInt::tuning_override small({gen() % 6 + 2, gen() % 24 + 3, gen() % 6 + 2, gen() % 24 + 3});
+        matches = matches && a * b == product && b * a == product;
+        squares = squares && a * a == square && (a + b) * (a + b) == square + (a * b << 1U) + b * b;
+    }
+    CHECK(matches);
+    CHECK(squares);
+
+    BigInt allOnes = (BigInt(1) << 64U * 300) - 1;
+    CHECK(allOnes * allOnes == (BigInt(1) << 64U * 600) - (BigInt(1) << (64U * 300 + 1)) + 1);
+}
+
+TEST_CASE("BigInt gcd by half-gcd agrees with Lehmer") {
+    std::mt19937_64 gen(61);
+    auto randomBig = [&gen](size_t limbs) {
+        BigInt value;
+        for (size_t i = 0; i < limbs; ++i) {
+            value = (value << 64U) + BigInt(static_cast<__int128>(gen() >> (gen() % 4 == 0 ? gen() % 64 : 0)));
+        }
+        return value;
+    };
+    bool matches = true;
+    for (int i = 0; i < 40; ++i) {
+        BigInt common = randomBig(gen() % 40 + 1);
+        BigInt a = randomBig(gen() % 300 + 1) * common, b = randomBig(gen() % 300 + 1) * common;
+        if (i % 8 == 0) {
+            b = a + common; // a quotient sequence of a single 1
+        }
+        BigInt lehmer;
+        {
+            BigInt::tuning_override lehmerOnly({.half_gcd = ~size_t(0)});
+            lehmer = gcd(a, b);
+        }
+        BigInt::tuning_override halving({.half_gcd = 3});
+        matches = matches && gcd(a, b) == lehmer && gcd(b, -a) == lehmer && lehmer % common == 0;
+    }
+    CHECK(matches);
+
+    // Consecutive Fibonacci numbers: Euclid's worst case, every quotient 1; gcd(F(m), F(n)) = F(gcd(m, n)).
+    std::vector<BigInt> fibonacci = {0, 1};
+    for (size_t i = 2; i <= 12000; ++i) {
+        fibonacci.push_back(fibonacci[i - 1] + fibonacci[i - 2]);
+    }
+    {
+        BigInt::tuning_override halving({.half_gcd = 3});
+        CHECK(gcd(fibonacci[12000], fibonacci[11999]) == 1);
+        CHECK(gcd(fibonacci[12000], fibonacci[9000]) == fibonacci[3000]);
+    }
+    CHECK(gcd(fibonacci[12000], fibonacci[9000]) == fibonacci[3000]);
+}
+
+TEST_CASE("BigInt decimal conversion splits at cached powers of 10") {
+    // References that go one 19-digit chunk at a time.
+    const BigInt chunk = BigInt(1000000000000000000LL) * 10;
+    auto chunkedString = [&chunk](BigInt value) {
+        std::vector<std::string> chunks;
+        for (value = value.abs(); !value.is_zero();) {
+            std::pair<BigInt, BigInt> parts = BigInt::divmod(value, chunk);
+            chunks.push_back(parts.second.to_string());
+            value = parts.first;
+        }
+        std::string text = chunks.empty() ? "0" : chunks.back();
+        for (size_t i = chunks.size() - 1; i-- > 0;) {
+            text += std::string(19 - chunks[i].size(), '0') + chunks[i];
+        }
+        return text;
+    };
+    auto chunkedParse = [&chunk](const std::string &text) {
+        BigInt value;
+        for (size_t i = text.size() % 19; i <= text.size(); i += 19) {
+            std::string part = text.substr(i >= 19 ? i - 19 : 0, i >= 19 ? 19 : i);
+            value = value * (i >= 19 ? chunk : BigInt(1)) + BigInt(static_cast<__int128>(part.empty() ? 0U : stoull(part)));
+        }
+        return value;
+    };
+    std::mt19937_64 gen(67);
+    bool printed = true, parsed = true;
+    for (int i = 0; i < 12; ++i) {
+        BigInt value;
+        size_t limbs = gen() % 1500 + 1;
+        for (size_t j = 0; j < limbs; ++j) {
+            value = (value << 64U) + BigInt(static_cast<__int128>(gen()));
+        }
+        std::string text = value.to_string();
+        printed = printed && text == chunkedString(value);
+        BigInt back;
+        from_chars(text.data(), text.data() + text.size(), back);
+        parsed = parsed && back == value && chunkedParse(text) == value;
+    }
+    CHECK(printed);
+    CHECK(parsed);
+
+    // Runs of 9s and of 0s stress the carries and the zero padding of the low halves.
+    bool exact = true;
+    for (size_t digits = 1000; digits <= 20000; digits += 6337) {
+        for (const std::string &text: {std::string(digits, '9'), '1' + std::string(digits, '0'),
+                                       '1' + std::string(digits, '0') + '1'}) {
+            BigInt value;
+            from_chars(text.data(), text.data() + text.size(), value);
+            exact = exact && value.to_string() == text && (-value).to_string() == '-' + text;
+        }
+        std::string padded = std::string(digits, '0') + "42";
+        BigInt small;
+        from_chars(padded.data(), padded.data() + padded.size(), small);
+        exact = exact && small == 42;
+    }
+    CHECK(exact);
+
+    BigInt big = chunkedParse(std::string(3000, '7'));
+    BigFraction frac(big + 1, big * 3);
+    std::stringstream stream;
+    stream << frac;
+    BigFraction read;
+    stream >> read;
+    CHECK(read == frac);
+}
@@ -15,11 +15,11 @@ TEST_CASE("Constructors initiated correctly") {
     float ff = 1.0 / 3;
     Fraction c(ff);
     CHECK(c == 1.0 / 3);
-    CHECK(c == b);
+    CHECK(approx_equal(c, b));
     double dd = 1.0 / 6;
     Fraction d(dd);
     CHECK(d == 2.0 / 12);
-    CHECK(d == c / 2);
+    CHECK(approx_equal(d, c / 2));
 }
 
 TEST_CASE("Reduced form") {
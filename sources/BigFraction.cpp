@@ -0,0 +1,207 @@
+#include "BigFraction.hpp"
+
+namespace ariel {
+    BigFraction::BigFraction(const BigInt &numerator, const BigInt &denominator)
+            : _numerator(numerator), _denominator(denominator) {
+        if (denominator.is_zero()) {
+            throw invalid_argument("INVALID ERROR: Denominator can not be 0!\n");
+        }
+        this->reducedForm();
+    }
+
+    void BigFraction::reducedForm() {
+        BigInt d = gcd(this->_numerator, this->_denominator);
+        if (this->_denominator.is_negative()) {
+            d = -d;
+        }
+        if (d != 1) {
+            this->_numerator = BigInt::divexact(this->_numerator, d);
+            this->_denominator = BigInt::divexact(this->_denominator, d);
+        }
+    }
+
+    BigFraction BigFraction::addScaled(const BigFraction &_frac1, const BigFraction &_frac2, bool subtract) {
+        BigFraction result;
+        BigInt d1 = gcd(_frac1._denominator, _frac2._denominator);
+        if (d1 == 1) {
+            BigInt left = _frac1._numerator * _frac2._denominator;
+            BigInt right = _frac2._numerator * _frac1._denominator;
+            result._numerator = subtract ? left - right : left + right;
+            result._denominator = _frac1._denominator * _frac2._denominator;
+            return result;
+        }
+        // Henrici: any common factor of the sum and the denominators divides d1.
+        BigInt scale1 = BigInt::divexact(_frac1._denominator, d1);
+        BigInt scale2 = BigInt::divexact(_frac2._denominator, d1);
+        BigInt left = _frac1._numerator * scale2;
+        BigInt right = _frac2._numerator * scale1;
+        BigInt sum = subtract ? left - right : left + right;
+        BigInt d2 = gcd(sum, d1);
+        if (d2 == 1) {
+            result._numerator = std::move(sum);
+            result._denominator = scale1 * _frac2._denominator;
+        } else {
+            result._numerator = BigInt::divexact(sum, d2);
+            result._denominator = scale1 * BigInt::divexact(_frac2._denominator, d2);
+        }
+        return result;
+    }
+
+    BigFraction operator+(const BigFraction &_frac1, const BigFraction &_frac2) {
+        return BigFraction::addScaled(_frac1, _frac2, false);
+    }
+
+    BigFraction operator-(const BigFraction &_frac1, const BigFraction &_frac2) {
+        return BigFraction::addScaled(_frac1, _frac2, true);
+    }
+
+    BigFraction operator*(const BigFraction &_frac1, const BigFraction &_frac2) {
+        // Cancel across before multiplying, so the product is already in lowest terms.
+        BigInt d1 = gcd(_frac1._numerator, _frac2._denominator);
+        BigInt d2 = gcd(_frac2._numerator, _frac1._denominator);
+        BigFraction result;
+        result._numerator = BigInt::divexact(_frac1._numerator, d1) * BigInt::divexact(_frac2._numerator, d2);
+        result._denominator = BigInt::divexact(_frac1._denominator, d2) * BigInt::divexact(_frac2._denominator, d1);
+        if (result._numerator.is_zero()) {
+            result._denominator = 1;
+        }
+        return result;
+    }
+
+    BigFraction operator/(const BigFraction &_frac1, const BigFraction &_frac2) {
+        if (_frac2._numerator.is_zero()) {
+            throw overflow_error("ARITHMETIC ERROR: Can not divide by 0!");
+        }
+        BigFraction reciprocal;
+        reciprocal._numerator = _frac2._numerator.is_negative() ? -_frac2._denominator : _frac2._denominator;
+        reciprocal._denominator = _frac2._numerator.abs();
+        return _frac1 * reciprocal;
+    }
+
+    BigFraction BigFraction::operator-() const {
+        BigFraction result = *this;
+        result._numerator = -result._numerator;
+        return result;
+    }
+
+    BigFraction &BigFraction::operator+=(const BigFraction &_frac) {
+        return *this = *this + _frac;
+    }
+
+    BigFraction &BigFraction::operator-=(const BigFraction &_frac) {
+        return *this = *this - _frac;
+    }
+
+    BigFraction &BigFraction::operator*=(const BigFraction &_frac) {
+        return *this = *this * _frac;
+    }
+
+    BigFraction &BigFraction::operator/=(const BigFraction &_frac) {
+        return *this = *this / _frac;
+    }
+
+    BigFraction &BigFraction::operator++() {
+        this->_numerator += this->_denominator;
+        return *this;
+    }
+
+    BigFraction BigFraction::operator++(int) {
+        BigFraction copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    BigFraction &BigFraction::operator--() {
+        this->_numerator -= this->_denominator;
+        return *this;
+    }
+
+    BigFraction BigFraction::operator--(int) {
+        BigFraction copy = *this;
+        --*this;
+        return copy;
+    }
+
+    strong_ordering operator<=>(const BigFraction &_frac1, const BigFraction &_frac2) {
+        int sign1 = _frac1._numerator.sign(), sign2 = _frac2._numerator.sign();
+        if (sign1 != sign2) {
+            return sign1 <=> sign2;
+        }
+        if (_frac1._denominator == _frac2._denominator) {
+            return _frac1._numerator <=> _frac2._numerator;
+        }
+        return _frac1._numerator * _frac2._denominator <=> _frac2._numerator * _frac1._denominator;
+    }
+
+    string BigFraction::to_string() const {
+        return this->_numerator.to_string() + '/' + this->_denominator.to_string();
+    }
+
+    optional<BigFraction> BigFraction::parse(string_view text) {
+        BigFraction value;
+        const char *end = text.data() + text.size();
+        from_chars_result result = from_chars(text.data(), end, value);
+        if (result.ec != errc{} || result.ptr != end) {
+            return nullopt;
+        }
+        return value;
+    }
+
+    from_chars_result from_chars(const char *first, const char *last, BigFraction &value) {
+        BigInt num, den = 1;
+        from_chars_result result = from_chars(first, last, num);
+        if (result.ec != errc{}) {
+            return result;
+        }
+        const char *pos = result.ptr;
+        if (pos != last && *pos == '/') {
+            result = from_chars(pos + 1, last, den);
+            if (result.ec != errc{}) {
+                return {first, errc::invalid_argument};
+            }
+        } else {
+            while (pos != last && (*pos == ' ' || *pos == '\t')) {
+                ++pos;
+            }
+            if (pos != result.ptr) {
+                // A plain integer when no second number follows the blanks.
+                BigInt second;
+                from_chars_result next = from_chars(pos, last, second);
+                if (next.ec == errc{}) {
+                    result = next;
+                    den = std::move(second);
+                }
+            }
+        }
+        if (den.is_zero()) {
+            return {first, errc::argument_out_of_domain};
+        }
+        value = BigFraction(num, den);
+        return result;
+    }
+
+    ostream &operator<<(ostream &output, const BigFraction &_frac) {
+        string text = _frac.to_string();
+        return output.write(text.data(), static_cast<streamsize>(text.size()));
+    }
+
+    istream &operator>>(istream &input, BigFraction &_frac) {
+        string text;
+        bool paired = readFractionPair(input, [&text](char c) {
+            text += c;
+            return true;
+        });
+        BigFraction value;
+        const char *end = text.data() + text.size();
+        from_chars_result result = from_chars(text.data(), end, value);
+        if (!paired || result.ec != errc{} || result.ptr != end) {
+            input.setstate(ios::failbit);
+            if (result.ec == errc::argument_out_of_domain) {
+                throw runtime_error("RUNTIME ERROR: Denominator can not be 0!\n");
+            }
+            throw runtime_error("RUNTIME ERROR: Expected a fraction \"n d\" or \"n/d\"!\n");
+        }
+        _frac = std::move(value);
+        return input;
+    }
+}
@@ -0,0 +1,147 @@
+#ifndef BIG_FRACTION_HPP
+#define BIG_FRACTION_HPP
+
+#include <charconv>
+#include <compare>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "BigInt.hpp"
+#include "Fraction.hpp"
+
+using namespace std;
+namespace ariel {
+    /**
+     * Fraction of two BigInts, for results that outgrow basic_fraction: arithmetic never
+     * overflows. Same invariant as basic_fraction under eager_reduce: the denominator is positive
+     * and the value is in lowest terms, so == compares the parts.
+     * Converts losslessly from any basic_fraction; to_fraction() converts back when the value fits.
+     */
+    class BigFraction {
+        BigInt _numerator, _denominator = 1;
+
+    public:
+        BigFraction() = default;
+
+        /**
+         * @throw invalid_argument when denominator is 0.
+         */
+        BigFraction(const BigInt &numerator, const BigInt &denominator);
+
+        /** Whole number n/1. */
+        BigFraction(BigInt n) : _numerator(std::move(n)) {}
+
+        template<fraction_integer I>
+        BigFraction(I n) : _numerator(n) {}
+
+        template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+        BigFraction(const basic_fraction<IntT, ReducePolicy, OverflowPolicy> &_frac)
+                : _numerator(_frac.getNumerator()), _denominator(_frac.getDenominator()) {}
+
+        const BigInt &getNumerator() const noexcept { return _numerator; }
+
+        const BigInt &getDenominator() const noexcept { return _denominator; }
+
+        /**
+         * The same value as a FractionT (a basic_fraction).
+         * @return Empty when the numerator or denominator does not fit.
+         */
+        template<typename FractionT = Fraction>
+        optional<FractionT> checked_to_fraction() const {
+            typename FractionT::int_type num = 0, den = 0;
+            if (!_numerator.fits(num) || !_denominator.fits(den)) {
+                return nullopt;
+            }
+            return FractionT(num, den);
+        }
+
+        /**
+         * @throw overflow_error when checked_to_fraction() is empty.
+         */
+        template<typename FractionT = Fraction>
+        FractionT to_fraction() const {
+            optional<FractionT> result = checked_to_fraction<FractionT>();
+            if (!result) {
+                throw overflow_error("OVERFLOW ERROR!\n");
+            }
+            return *result;
+        }
+
+        // Arithmetic operations:
+        friend BigFraction operator+(const BigFraction &_frac1, const BigFraction &_frac2);
+
+        friend BigFraction operator-(const BigFraction &_frac1, const BigFraction &_frac2);
+
+        friend BigFraction operator*(const BigFraction &_frac1, const BigFraction &_frac2);
+
+        /**
+         * @throw overflow_error when _frac2 is 0.
+         */
+        friend BigFraction operator/(const BigFraction &_frac1, const BigFraction &_frac2);
+
+        BigFraction operator-() const;
+
+        BigFraction &operator+=(const BigFraction &_frac);
+
+        BigFraction &operator-=(const BigFraction &_frac);
+
+        BigFraction &operator*=(const BigFraction &_frac);
+
+        BigFraction &operator/=(const BigFraction &_frac);
+
+        BigFraction &operator++();
+
+        BigFraction operator++(int);
+
+        BigFraction &operator--();
+
+        BigFraction operator--(int);
+
+        // Comparison operations:
+        friend bool operator==(const BigFraction &_frac1, const BigFraction &_frac2) = default;
+
+        friend strong_ordering operator<=>(const BigFraction &_frac1, const BigFraction &_frac2);
+
+        /** "n/d" in lowest terms. */
+        string to_string() const;
+
+        /**
+         * Parses the whole of text as from_chars() does.
+         * @return Empty when text is not exactly one fraction or integer.
+         */
+        static optional<BigFraction> parse(string_view text);
+
+        /**
+         * from_chars() of basic_fraction without the range limit: reads "n/d", "n d" (spaces or
+         * tabs between) or a plain integer n, with n and d decimal and optionally '-'-signed.
+         * @return ptr past the parsed text; on error value is left unchanged and ec is
+         * errc::invalid_argument when there is no number at first and errc::argument_out_of_domain
+         * when the denominator is 0.
+         */
+        friend from_chars_result from_chars(const char *first, const char *last, BigFraction &value);
+
+        // I/O operations:
+        friend ostream &operator<<(ostream &output, const BigFraction &_frac);
+
+        /**
+         * Reads "n d" or "n/d" like basic_fraction's operator>>, with no limit on the digits.
+         * @throw runtime_error (after setting failbit) when the input is not such a pair or the
+         * denominator is 0.
+         */
+        friend istream &operator>>(istream &input, BigFraction &_frac);
+
+    private:
+        /**
+         * Reduce the fraction to it's minimal form and make the denominator positive.
+         */
+        void reducedForm();
+
+        /**
+         * _frac1 + _frac2 or _frac1 - _frac2, dividing by the gcd of the denominators first so
+         * the products stay small.
+         */
+        static BigFraction addScaled(const BigFraction &_frac1, const BigFraction &_frac2, bool subtract);
+    };
+}
+#endif
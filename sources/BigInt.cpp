@@ -0,0 +1,1110 @@
+#include "BigInt.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <deque>
+
+namespace ariel {
+    namespace {
+        using limb = std::uint64_t;
+        using limb_vector = std::vector<limb>;
+        using wide = unsigned __int128;
+
+        // Below this many limbs halfGcd() runs Lehmer (with cofactor tracking) instead of recursing.
+        constexpr std::size_t halfGcdBase = 48;
+
+        // The sizes multiplication and gcd() go by on this thread; see BigInt::tuning_override.
+        thread_local BigInt::tuning activeTuning = BigInt::default_tuning;
+
+        // 10^19, the largest power of ten in a limb.
+        constexpr limb chunkBase = 10000000000000000000ULL;
+        constexpr int chunkDigits = 19;
+
+        // Below this many limbs decimal conversion goes chunk by chunk instead of splitting in halves.
+        constexpr std::size_t radixBase = 32;
+
+        void trimLimbs(limb_vector &value) noexcept {
+            while (!value.empty() && value.back() == 0) {
+                value.pop_back();
+            }
+        }
+
+        int compareMagnitudes(const limb_vector &_n1, const limb_vector &_n2) noexcept {
+            if (_n1.size() != _n2.size()) {
+                return _n1.size() < _n2.size() ? -1 : 1;
+            }
+            for (std::size_t i = _n1.size(); i-- > 0;) {
+                if (_n1[i] != _n2[i]) {
+                    return _n1[i] < _n2[i] ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+
+        limb_vector addMagnitudes(const limb_vector &_n1, const limb_vector &_n2) {
+            const limb_vector &longer = _n1.size() >= _n2.size() ? _n1 : _n2;
+            const limb_vector &shorter = _n1.size() >= _n2.size() ? _n2 : _n1;
+            limb_vector result(longer.size() + 1);
+            limb carry = 0;
+            for (std::size_t i = 0; i < longer.size(); ++i) {
+                wide sum = static_cast<wide>(longer[i]) + (i < shorter.size() ? shorter[i] : 0U) + carry;
+                result[i] = static_cast<limb>(sum);
+                carry = static_cast<limb>(sum >> 64U);
+            }
+            result.back() = carry;
+            trimLimbs(result);
+            return result;
+        }
+
+        /** _n1 - _n2 for _n1 >= _n2. */
+        limb_vector subMagnitudes(const limb_vector &_n1, const limb_vector &_n2) {
+            limb_vector result(_n1.size());
+            limb borrow = 0;
+            for (std::size_t i = 0; i < _n1.size(); ++i) {
+                limb subtrahend = i < _n2.size() ? _n2[i] : 0U;
+                limb diff = _n1[i] - subtrahend;
+                limb borrowOut = _n1[i] < subtrahend ? 1U : 0U;
+                result[i] = diff - borrow;
+                borrow = borrowOut | (diff < borrow ? 1U : 0U);
+            }
+            trimLimbs(result);
+            return result;
+        }
+
+        /** (hi:lo) / den with hi < den, returning the remainder in rem. */
+        inline limb divideWide(limb hi, limb lo, limb den, limb &rem) noexcept {
+#if defined(__x86_64__)
+            limb quotient = 0;
+            __asm__("divq %[den]" : "=a"(quotient), "=d"(rem) : [den] "r"(den), "a"(lo), "d"(hi));
+            return quotient;
+#else
+            wide value = static_cast<wide>(hi) << 64U | lo;
+            rem = static_cast<limb>(value % den);
+            return static_cast<limb>(value / den);
+#endif
+        }
+
+        /** value = value * factor + addend. */
+        void mulAddLimb(limb_vector &value, limb factor, limb addend) {
+            limb carry = addend;
+            for (limb &part: value) {
+                wide product = static_cast<wide>(part) * factor + carry;
+                part = static_cast<limb>(product);
+                carry = static_cast<limb>(product >> 64U);
+            }
+            if (carry != 0) {
+                value.push_back(carry);
+            }
+        }
+
+        /** value /= den, returning the remainder. */
+        limb divideByLimb(limb_vector &value, limb den) noexcept {
+            limb rem = 0;
+            for (std::size_t i = value.size(); i-- > 0;) {
+                value[i] = divideWide(rem, value[i], den, rem);
+            }
+            trimLimbs(value);
+            return rem;
+        }
+
+        limb_vector shiftLeft(const limb_vector &value, std::size_t bits) {
+            if (value.empty()) {
+                return {};
+            }
+            std::size_t limbShift = bits / 64U;
+            unsigned bitShift = bits % 64U;
+            limb_vector result(value.size() + limbShift + 1);
+            for (std::size_t i = 0; i < value.size(); ++i) {
+                result[i + limbShift] |= value[i] << bitShift;
+                if (bitShift != 0) {
+                    result[i + limbShift + 1] = value[i] >> (64U - bitShift);
+                }
+            }
+            trimLimbs(result);
+            return result;
+        }
+
+        limb_vector shiftRight(const limb_vector &value, std::size_t bits) {
+            std::size_t limbShift = bits / 64U;
+            if (limbShift >= value.size()) {
+                return {};
+            }
+            unsigned bitShift = bits % 64U;
+            limb_vector result(value.size() - limbShift);
+            for (std::size_t i = 0; i < result.size(); ++i) {
+                result[i] = value[i + limbShift] >> bitShift;
+                if (bitShift != 0 && i + limbShift + 1 < value.size()) {
+                    result[i] |= value[i + limbShift + 1] << (64U - bitShift);
+                }
+            }
+            trimLimbs(result);
+            return result;
+        }
+
+        /** r[0, nr) += a[0, na) for na <= nr, returning the carry out of r. */
+        limb addInPlace(limb *r, std::size_t nr, const limb *a, std::size_t na) noexcept {
+            limb carry = 0;
+            std::size_t i = 0;
+            for (; i < na; ++i) {
+                wide sum = static_cast<wide>(r[i]) + a[i] + carry;
+                r[i] = static_cast<limb>(sum);
+                carry = static_cast<limb>(sum >> 64U);
+            }
+            for (; carry != 0 && i < nr; ++i) {
+                carry = ++r[i] == 0 ? 1U : 0U;
+            }
+            return carry;
+        }
+
+        /** r[0, nr) -= a[0, na) for na <= nr, returning the borrow out of r. */
+        limb subInPlace(limb *r, std::size_t nr, const limb *a, std::size_t na) noexcept {
+            limb borrow = 0;
+            std::size_t i = 0;
+            for (; i < na; ++i) {
+                limb diff = r[i] - a[i];
+                limb borrowOut = r[i] < a[i] ? 1U : 0U;
+                r[i] = diff - borrow;
+                borrow = borrowOut | (diff < borrow ? 1U : 0U);
+            }
+            for (; borrow != 0 && i < nr; ++i) {
+                borrow = r[i]-- == 0 ? 1U : 0U;
+            }
+            return borrow;
+        }
+
+        /** out[0, na + nb) = a * b, out zeroed by the caller. */
+        void mulSchoolbook(const limb *a, std::size_t na, const limb *b, std::size_t nb, limb *out) noexcept {
+            for (std::size_t i = 0; i < na; ++i) {
+                limb carry = 0;
+                for (std::size_t j = 0; j < nb; ++j) {
+                    wide product = static_cast<wide>(a[i]) * b[j] + out[i + j] + carry;
+                    out[i + j] = static_cast<limb>(product);
+                    carry = static_cast<limb>(product >> 64U);
+                }
+                out[i + nb] = carry;
+            }
+        }
+
+        /**
+         * out[0, 2n) = a * a, out zeroed by the caller: each cross product a[i] * a[j] is formed
+         * once and doubled, so about half the limb products of mulSchoolbook().
+         */
+        void sqrSchoolbook(const limb *a, std::size_t n, limb *out) noexcept {
+            for (std::size_t i = 0; i + 1 < n; ++i) {
+                limb carry = 0;
+                for (std::size_t j = i + 1; j < n; ++j) {
+                    wide product = static_cast<wide>(a[i]) * a[j] + out[i + j] + carry;
+                    out[i + j] = static_cast<limb>(product);
+                    carry = static_cast<limb>(product >> 64U);
+                }
+                out[i + n] = carry;
+            }
+            limb top = 0;
+            for (std::size_t i = 0; i < 2 * n; ++i) {
+                limb next = out[i] >> 63U;
+                out[i] = out[i] << 1U | top;
+                top = next;
+            }
+            limb carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                wide square = static_cast<wide>(a[i]) * a[i];
+                wide low = static_cast<wide>(out[2 * i]) + static_cast<limb>(square) + carry;
+                out[2 * i] = static_cast<limb>(low);
+                wide high = static_cast<wide>(out[2 * i + 1]) + static_cast<limb>(square >> 64U) + (low >> 64U);
+                out[2 * i + 1] = static_cast<limb>(high);
+                carry = static_cast<limb>(high >> 64U);
+            }
+        }
+
+        void mulInto(const limb *a, std::size_t na, const limb *b, std::size_t nb, limb *out);
+
+        /** a[from, to) (clamped to na) without leading zero limbs. */
+        limb_vector slice(const limb *a, std::size_t na, std::size_t from, std::size_t to) {
+            limb_vector result(a + std::min(from, na), a + std::min(to, na));
+            trimLimbs(result);
+            return result;
+        }
+
+        limb_vector mulVectors(const limb_vector &x, const limb_vector &y) {
+            if (x.empty() || y.empty()) {
+                return {};
+            }
+            limb_vector result(x.size() + y.size());
+            mulInto(x.data(), x.size(), y.data(), y.size(), result.data());
+            trimLimbs(result);
+            return result;
+        }
+
+        /**
+         * Karatsuba for nb <= na < 2 nb: with a = a1 B^m + a0 and b = b1 B^m + b0,
+         * a b = z2 B^2m + z1 B^m + z0 where z1 = (a0 + a1)(b0 + b1) - z0 - z2, three half-size
+         * products instead of four. Squares (a == b) recurse as squares.
+         */
+        void mulKaratsuba(const limb *a, std::size_t na, const limb *b, std::size_t nb, limb *out) {
+            bool square = a == b && na == nb;
+            std::size_t m = na / 2, high = na - m;
+            mulInto(a, m, b, m, out);
+            mulInto(a + m, high, b + m, nb - m, out + 2 * m);
+            // The two sums (high + 1 limbs each) and their product, in one allocation.
+            limb_vector scratch(4 * (high + 1));
+            limb *sumA = scratch.data(), *sumB = sumA + high + 1, *middle = sumB + high + 1;
+            auto addHalves = [m, high](const limb *x, std::size_t nx, limb *sum) {
+                std::copy(x + m, x + nx, sum);
+                sum[high] = addInPlace(sum, high, x, m);
+                std::size_t size = high + 1;
+                while (size > 0 && sum[size - 1] == 0) {
+                    --size;
+                }
+                return size;
+            };
+            std::size_t sizeA = addHalves(a, na, sumA);
+            std::size_t sizeB = square ? sizeA : addHalves(b, nb, sumB);
+            mulInto(sumA, sizeA, square ? sumA : sumB, sizeB, middle);
+            // middle - z0 - z2 >= 0 fits in 2 high + 2 limbs.
+            std::size_t size = 2 * high + 2;
+            subInPlace(middle, size, out, 2 * m);
+            subInPlace(middle, size, out + 2 * m, na + nb - 2 * m);
+            while (size > 0 && middle[size - 1] == 0) {
+                --size;
+            }
+            addInPlace(out + m, na + nb - m, middle, size);
+        }
+
+        /** A signed intermediate of Toom-3's evaluation and interpolation. */
+        struct signed_limbs {
+            limb_vector magnitude;
+            bool negative = false;
+        };
+
+        signed_limbs addSigned(const signed_limbs &x, const signed_limbs &y, bool subtract = false) {
+            bool yNegative = y.negative != subtract;
+            if (x.negative == yNegative) {
+                return {addMagnitudes(x.magnitude, y.magnitude), x.negative};
+            }
+            if (compareMagnitudes(x.magnitude, y.magnitude) >= 0) {
+                limb_vector diff = subMagnitudes(x.magnitude, y.magnitude);
+                bool negative = x.negative && !diff.empty();
+                return {std::move(diff), negative};
+            }
+            return {subMagnitudes(y.magnitude, x.magnitude), yNegative};
+        }
+
+        signed_limbs mulSigned(const signed_limbs &x, const signed_limbs &y) {
+            limb_vector product = &x == &y ? mulVectors(x.magnitude, x.magnitude) : mulVectors(x.magnitude, y.magnitude);
+            bool negative = x.negative != y.negative && !product.empty();
+            return {std::move(product), negative};
+        }
+
+        /**
+         * Toom-3 for 2 na < 3 nb: splits both operands in three and multiplies at the points
+         * 0, 1, -1, -2 and infinity, five third-size products instead of nine, then
+         * interpolates with Bodrato's sequence (exact divisions by 2 and 3 only).
+         */
+        void mulToom3(const limb *a, std::size_t na, const limb *b, std::size_t nb, limb *out) {
+            bool square = a == b && na == nb;
+            std::size_t k = (na + 2) / 3;
+            auto evaluate = [k](const limb *x, std::size_t nx, signed_limbs (&values)[5]) {
+                signed_limbs x0{slice(x, nx, 0, k)}, x1{slice(x, nx, k, 2 * k)}, x2{slice(x, nx, 2 * k, nx)};
+                signed_limbs outer = addSigned(x0, x2);
+                values[0] = x0;
+                values[1] = addSigned(outer, x1);
+                values[2] = addSigned(outer, x1, true);
+                signed_limbs twice = addSigned(values[2], x2);
+                twice.magnitude = shiftLeft(twice.magnitude, 1);
+                values[3] = addSigned(twice, x0, true);
+                values[4] = x2;
+            };
+            signed_limbs valuesA[5], valuesB[5], r[5];
+            evaluate(a, na, valuesA);
+            if (!square) {
+                evaluate(b, nb, valuesB);
+            }
+            for (int i = 0; i < 5; ++i) {
+                r[i] = square ? mulSigned(valuesA[i], valuesA[i]) : mulSigned(valuesA[i], valuesB[i]);
+            }
+            // r = {r(0), r(1), r(-1), r(-2), r(inf)} becomes the coefficients of the product.
+            signed_limbs r3 = addSigned(r[3], r[1], true);
+            divideByLimb(r3.magnitude, 3);
+            signed_limbs r1 = addSigned(r[1], r[2], true);
+            r1.magnitude = shiftRight(r1.magnitude, 1);
+            signed_limbs r2 = addSigned(r[2], r[0], true);
+            r3 = addSigned(r2, r3, true);
+            r3.magnitude = shiftRight(r3.magnitude, 1);
+            r3 = addSigned(r3, signed_limbs{shiftLeft(r[4].magnitude, 1)});
+            r2 = addSigned(addSigned(r2, r1), r[4], true);
+            r1 = addSigned(r1, r3, true);
+            const limb_vector *coefficients[5] = {&r[0].magnitude, &r1.magnitude, &r2.magnitude,
+                                                  &r3.magnitude, &r[4].magnitude};
+            for (std::size_t i = 0; i < 5; ++i) {
+                const limb_vector &c = *coefficients[i];
+                if (!c.empty()) {
+                    addInPlace(out + i * k, na + nb - i * k, c.data(), c.size());
+                }
+            }
+        }
+
+        /** out[0, na + nb) = a * b, out zeroed by the caller, choosing the algorithm by size. */
+        void mulInto(const limb *a, std::size_t na, const limb *b, std::size_t nb, limb *out) {
+            if (na < nb) {
+                std::swap(a, b);
+                std::swap(na, nb);
+            }
+            const BigInt::tuning &limits = activeTuning;
+            if (a == b && na == nb) {
+                if (na < limits.karatsuba_square) {
+                    sqrSchoolbook(a, na, out);
+                } else if (na < limits.toom3_square) {
+                    mulKaratsuba(a, na, a, na, out);
+                } else {
+                    mulToom3(a, na, a, na, out);
+                }
+            } else if (nb < limits.karatsuba) {
+                mulSchoolbook(a, na, b, nb, out);
+            } else if (na >= 2 * nb) {
+                // Unbalanced: nb-limb slices of a times b, each product balanced.
+                limb_vector part(2 * nb);
+                for (std::size_t i = 0; i < na; i += nb) {
+                    std::size_t size = std::min(nb, na - i);
+                    std::fill(part.begin(), part.end(), 0);
+                    mulInto(a + i, size, b, nb, part.data());
+                    addInPlace(out + i, na + nb - i, part.data(), size + nb);
+                }
+            } else if (nb < limits.toom3 || 2 * na >= 3 * nb) {
+                mulKaratsuba(a, na, b, nb, out);
+            } else {
+                mulToom3(a, na, b, nb, out);
+            }
+        }
+
+        limb_vector mulMagnitudes(const limb_vector &_n1, const limb_vector &_n2) {
+            return &_n1 == &_n2 ? mulVectors(_n1, _n1) : mulVectors(_n1, _n2);
+        }
+
+        /**
+         * Knuth's algorithm D: quot = _n1 / _n2 and rem = _n1 % _n2 for magnitudes with
+         * _n2.size() >= 2 and _n1 >= _n2.
+         */
+        void divideKnuth(const limb_vector &_n1, const limb_vector &_n2, limb_vector &quot, limb_vector &rem) {
+            // Normalize so the divisor's top bit is set; the quotient digit estimates are then
+            // at most 2 too large.
+            auto shift = static_cast<unsigned>(std::countl_zero(_n2.back()));
+            std::size_t n = _n2.size(), m = _n1.size() - n;
+            limb_vector v(n), u(_n1.size() + 1);
+            for (std::size_t i = n; i-- > 0;) {
+                v[i] = _n2[i] << shift | (shift != 0 && i > 0 ? _n2[i - 1] >> (64U - shift) : 0U);
+            }
+            u[_n1.size()] = shift != 0 ? _n1.back() >> (64U - shift) : 0U;
+            for (std::size_t i = _n1.size(); i-- > 0;) {
+                u[i] = _n1[i] << shift | (shift != 0 && i > 0 ? _n1[i - 1] >> (64U - shift) : 0U);
+            }
+            quot.assign(m + 1, 0);
+            for (std::size_t j = m + 1; j-- > 0;) {
+                wide qhat = 0, rhat = 0;
+                if (u[j + n] >= v[n - 1]) {
+                    // The estimate is at least 2^64; start from 2^64 - 1 instead.
+                    qhat = ~limb(0);
+                    rhat = (static_cast<wide>(u[j + n]) << 64U | u[j + n - 1]) - qhat * v[n - 1];
+                } else {
+                    limb r = 0;
+                    qhat = divideWide(u[j + n], u[j + n - 1], v[n - 1], r);
+                    rhat = r;
+                }
+                while (rhat >> 64U == 0 && qhat * v[n - 2] > (rhat << 64U | u[j + n - 2])) {
+                    --qhat;
+                    rhat += v[n - 1];
+                }
+                // u[j, j + n] -= qhat * v
+                limb carry = 0, borrow = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    wide product = qhat * v[i] + carry;
+                    carry = static_cast<limb>(product >> 64U);
+                    auto low = static_cast<limb>(product);
+                    limb diff = u[i + j] - low;
+                    limb borrowOut = u[i + j] < low ? 1U : 0U;
+                    u[i + j] = diff - borrow;
+                    borrow = borrowOut | (diff < borrow ? 1U : 0U);
+                }
+                limb top = u[j + n] - carry;
+                bool negative = u[j + n] < carry || top < borrow;
+                u[j + n] = top - borrow;
+                if (negative) {
+                    // qhat was one too large: add v back.
+                    --qhat;
+                    limb addCarry = 0;
+                    for (std::size_t i = 0; i < n; ++i) {
+                        wide sum = static_cast<wide>(u[i + j]) + v[i] + addCarry;
+                        u[i + j] = static_cast<limb>(sum);
+                        addCarry = static_cast<limb>(sum >> 64U);
+                    }
+                    u[j + n] += addCarry;
+                }
+                quot[j] = static_cast<limb>(qhat);
+            }
+            trimLimbs(quot);
+            u.resize(n);
+            trimLimbs(u);
+            rem = shiftRight(u, shift);
+        }
+
+        void divideMagnitudes(const limb_vector &_n1, const limb_vector &_n2, limb_vector &quot, limb_vector &rem) {
+            if (compareMagnitudes(_n1, _n2) < 0) {
+                quot.clear();
+                rem = _n1;
+            } else if (_n2.size() == 1) {
+                quot = _n1;
+                limb r = divideByLimb(quot, _n2[0]);
+                rem.assign(r != 0 ? 1 : 0, r);
+            } else {
+                divideKnuth(_n1, _n2, quot, rem);
+            }
+        }
+
+        /**
+         * _n1 / _n2 for magnitudes where _n2 divides _n1 (Jebelean's exact division). With the
+         * divisor made odd, each quotient limb, lowest first, is the low limb of what is left times
+         * the inverse of the divisor's low limb mod 2^64: no estimates, no corrections and no
+         * remainder, and limbs above the quotient's length are never touched.
+         */
+        limb_vector divideExact(const limb_vector &_n1, const limb_vector &_n2) {
+            if (compareMagnitudes(_n1, _n2) < 0) {
+                return {};
+            }
+            std::size_t low = 0;
+            while (_n2[low] == 0) {
+                ++low;
+            }
+            std::size_t zeros = 64U * low + static_cast<std::size_t>(std::countr_zero(_n2[low]));
+            limb_vector u = shiftRight(_n1, zeros), v = shiftRight(_n2, zeros);
+            // Newton's iteration doubles the correct low bits; an odd v[0] is its own inverse mod 8.
+            limb inverse = v[0];
+            for (int i = 0; i < 5; ++i) {
+                inverse *= 2U - v[0] * inverse;
+            }
+            std::size_t n = u.size() - v.size() + 1;
+            limb_vector quot(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                limb q = u[i] * inverse;
+                quot[i] = q;
+                // u[i, n) -= q * v, the multiply carry and the borrow folded into one.
+                limb carry = 0;
+                for (std::size_t j = 0; j < v.size() && i + j < n; ++j) {
+                    wide product = static_cast<wide>(q) * v[j] + carry;
+                    auto low = static_cast<limb>(product);
+                    carry = static_cast<limb>(product >> 64U) + (u[i + j] < low ? 1U : 0U);
+                    u[i + j] -= low;
+                }
+                for (std::size_t j = i + v.size(); carry != 0 && j < n; ++j) {
+                    limb low = carry;
+                    carry = u[j] < low ? 1U : 0U;
+                    u[j] -= low;
+                }
+            }
+            trimLimbs(quot);
+            return quot;
+        }
+
+        /** The bits [shift, shift + 62) of value (0 past its end). */
+        std::int64_t topBits(const limb_vector &value, std::size_t shift) noexcept {
+            std::size_t index = shift / 64U;
+            unsigned offset = shift % 64U;
+            if (index >= value.size()) {
+                return 0;
+            }
+            wide window = value[index];
+            if (index + 1 < value.size()) {
+                window |= static_cast<wide>(value[index + 1]) << 64U;
+            }
+            return static_cast<std::int64_t>((window >> offset) & ((limb(1) << 62U) - 1));
+        }
+
+        /** |a * x + b * y| for cofactors of opposite signs (or zero), a result known to be >= 0. */
+        limb_vector combine(const limb_vector &x, std::int64_t a, const limb_vector &y, std::int64_t b) {
+            // Put the positive term first (a may be 0 with b > 0).
+            bool xPlus = a > 0 || b < 0;
+            const limb_vector &plus = xPlus ? x : y;
+            const limb_vector &minus = xPlus ? y : x;
+            auto plusFactor = static_cast<limb>(xPlus ? a : b);
+            auto minusFactor = static_cast<limb>(xPlus ? -b : -a);
+            limb_vector result(plus.size() + 1);
+            limb carryPlus = 0, carryMinus = 0, borrow = 0;
+            for (std::size_t i = 0; i < result.size(); ++i) {
+                wide p = static_cast<wide>(i < plus.size() ? plus[i] : 0U) * plusFactor + carryPlus;
+                wide q = static_cast<wide>(i < minus.size() ? minus[i] : 0U) * minusFactor + carryMinus;
+                carryPlus = static_cast<limb>(p >> 64U);
+                carryMinus = static_cast<limb>(q >> 64U);
+                auto low = static_cast<limb>(p), sub = static_cast<limb>(q);
+                limb diff = low - sub;
+                limb borrowOut = low < sub ? 1U : 0U;
+                result[i] = diff - borrow;
+                borrow = borrowOut | (diff < borrow ? 1U : 0U);
+            }
+            trimLimbs(result);
+            return result;
+        }
+
+        wide toWide(const limb_vector &value) noexcept {
+            wide result = 0;
+            for (std::size_t i = value.size(); i-- > 0;) {
+                result = result << 64U | value[i];
+            }
+            return result;
+        }
+
+        std::size_t bitWidthOf(const limb_vector &value) noexcept {
+            if (value.empty()) {
+                return 0;
+            }
+            return 64U * value.size() - static_cast<std::size_t>(std::countl_zero(value.back()));
+        }
+
+        /** Cofactors of Lehmer's inner loop: (a x + b y, c x + d y) continues Euclid on (x, y). */
+        struct lehmer_step {
+            std::int64_t a = 1, b = 0, c = 0, d = 1;
+        };
+
+        /**
+         * Euclid on the leading 62 bits of x >= y (x at least 62 bits wide), for as long as the
+         * quotients are certainly those of x and y (Knuth, TAOCP 4.5.2). A nonzero floor also
+         * stops it before the remainder could shrink to floor bits or fewer. b == 0 means no step
+         * was taken.
+         */
+        lehmer_step lehmerCofactors(const limb_vector &x, const limb_vector &y, std::size_t floor = 0) noexcept {
+            std::size_t shift = bitWidthOf(x) - 62U;
+            std::int64_t u = topBits(x, shift), v = topBits(y, shift);
+            lehmer_step step;
+            auto &[a, b, c, d] = step;
+            while (v + c != 0 && v + d != 0) {
+                std::int64_t q = (u + a) / (v + c);
+                if (q != (u + b) / (v + d)) {
+                    break;
+                }
+                std::int64_t t = u - q * v, nextC = a - q * c, nextD = b - q * d;
+                if (floor != 0) {
+                    // The remainder is t 2^shift give or take its cofactors times 2^shift.
+                    int width = bitWidth(static_cast<limb>(t));
+                    int error = bitWidth(static_cast<limb>(std::max(magnitude(nextC), magnitude(nextD))));
+                    if (shift + static_cast<std::size_t>(width) <= floor + 1 || width <= error + 1) {
+                        break;
+                    }
+                }
+                u = v;
+                v = t;
+                a = c;
+                c = nextC;
+                b = d;
+                d = nextD;
+            }
+            return step;
+        }
+
+        /**
+         * A reduction (x, y) = M (x', y') by Euclid's steps: nonnegative entries and det M = +-1.
+         */
+        struct cofactor_matrix {
+            limb_vector m00{1}, m01, m10, m11{1};
+        };
+
+        /** M = M N. */
+        void multiplyMatrix(cofactor_matrix &M, const cofactor_matrix &N) {
+            cofactor_matrix product;
+            product.m00 = addMagnitudes(mulVectors(M.m00, N.m00), mulVectors(M.m01, N.m10));
+            product.m01 = addMagnitudes(mulVectors(M.m00, N.m01), mulVectors(M.m01, N.m11));
+            product.m10 = addMagnitudes(mulVectors(M.m10, N.m00), mulVectors(M.m11, N.m10));
+            product.m11 = addMagnitudes(mulVectors(M.m10, N.m01), mulVectors(M.m11, N.m11));
+            M = std::move(product);
+        }
+
+        /** |p x - q y| */
+        limb_vector absDifference(const limb_vector &p, const limb_vector &x, const limb_vector &q,
+                                  const limb_vector &y) {
+            limb_vector first = mulVectors(p, x), second = mulVectors(q, y);
+            return compareMagnitudes(first, second) >= 0 ? subMagnitudes(first, second) : subMagnitudes(second, first);
+        }
+
+        /**
+         * (x, y) = M^-1 (x, y), swapping them (and the columns of M) if needed to keep x >= y.
+         * Whatever M is, this is unimodular, so the gcd is kept.
+         */
+        void applyInverse(cofactor_matrix &M, limb_vector &x, limb_vector &y) {
+            limb_vector nextX = absDifference(M.m11, x, M.m01, y);
+            limb_vector nextY = absDifference(M.m00, y, M.m10, x);
+            x = std::move(nextX);
+            y = std::move(nextY);
+            if (compareMagnitudes(x, y) < 0) {
+                std::swap(x, y);
+                std::swap(M.m00, M.m01);
+                std::swap(M.m10, M.m11);
+            }
+        }
+
+        /** (x, y) = (y, rem) for rem = x mod y, with quot = x / y appended to M when given. */
+        void euclidStep(limb_vector &x, limb_vector &y, const limb_vector &quot, limb_vector &rem, cofactor_matrix *M) {
+            x = std::move(y);
+            y = std::move(rem);
+            if (M != nullptr) {
+                limb_vector m00 = addMagnitudes(mulVectors(M->m00, quot), M->m01);
+                limb_vector m10 = addMagnitudes(mulVectors(M->m10, quot), M->m11);
+                M->m01 = std::move(M->m00);
+                M->m00 = std::move(m00);
+                M->m11 = std::move(M->m10);
+                M->m10 = std::move(m10);
+            }
+        }
+
+        /** (x, y) = (y, x mod y) for y != 0. */
+        void euclidStep(limb_vector &x, limb_vector &y) {
+            limb_vector quot, rem;
+            divideMagnitudes(x, y, quot, rem);
+            euclidStep(x, y, quot, rem, nullptr);
+        }
+
+        /** Applies Lehmer cofactors to (x, y), appending them to M when given. */
+        void lehmerUpdate(limb_vector &x, limb_vector &y, const lehmer_step &step, cofactor_matrix *M) {
+            limb_vector nextX = combine(x, step.a, y, step.b);
+            limb_vector nextY = combine(x, step.c, y, step.d);
+            x = std::move(nextX);
+            y = std::move(nextY);
+            if (M != nullptr) {
+                // The cofactors alternate in sign, so the inverse is [[|d|, |b|], [|c|, |a|]].
+                auto entry = [](std::int64_t value) {
+                    return value == 0 ? limb_vector{} : limb_vector{magnitude(value)};
+                };
+                multiplyMatrix(*M, {entry(step.d), entry(step.b), entry(step.c), entry(step.a)});
+            }
+        }
+
+        /** Lehmer, then single steps, for as long as the remainder keeps more than s bits. */
+        void reduceAbove(limb_vector &x, limb_vector &y, std::size_t s, cofactor_matrix *M) {
+            limb_vector quot, rem;
+            while (bitWidthOf(y) > s) {
+                if (bitWidthOf(x) >= 62) {
+                    lehmer_step step = lehmerCofactors(x, y, s);
+                    if (step.b != 0) {
+                        lehmerUpdate(x, y, step, M);
+                        continue;
+                    }
+                }
+                divideMagnitudes(x, y, quot, rem);
+                if (bitWidthOf(rem) <= s) {
+                    return;
+                }
+                euclidStep(x, y, quot, rem, M);
+            }
+        }
+
+        /**
+         * Half-gcd (Moller's form of Schonhage's algorithm) for x >= y: continues Euclid for as
+         * long as y keeps more than s = bits(x) / 2 + 1 bits, appending the steps to M when given.
+         * The steps are found by two recursive calls on leading bits, each covering a quarter of
+         * the reduction, so the cost is O(M(n) log n) instead of Lehmer's O(n^2). Keeping y above
+         * s is what makes the steps found from leading bits valid for the whole values.
+         */
+        void halfGcd(limb_vector &x, limb_vector &y, cofactor_matrix *M) {
+            std::size_t n = bitWidthOf(x), s = n / 2 + 1;
+            if (x.size() < halfGcdBase) {
+                reduceAbove(x, y, s, M);
+                return;
+            }
+            auto recurse = [&x, &y, M](std::size_t shift) {
+                cofactor_matrix steps;
+                limb_vector highX = shiftRight(x, shift), highY = shiftRight(y, shift);
+                halfGcd(highX, highY, &steps);
+                applyInverse(steps, x, y);
+                if (M != nullptr) {
+                    multiplyMatrix(*M, steps);
+                }
+            };
+            // The leading n - n/2 bits take y down to about 3n/4 bits ...
+            recurse(n / 2);
+            limb_vector quot, rem;
+            if (bitWidthOf(y) <= s) {
+                return;
+            }
+            divideMagnitudes(x, y, quot, rem);
+            if (bitWidthOf(rem) <= s) {
+                return;
+            }
+            euclidStep(x, y, quot, rem, M);
+            // ... and the leading 2 (bits(x) - s) bits the rest of the way to s.
+            std::size_t width = bitWidthOf(x);
+            if (width > s + 64) {
+                recurse(2 * s > width ? 2 * s - width : 0);
+            }
+            reduceAbove(x, y, s, M);
+        }
+        /**
+         * power = 10^(19 * 2^k), the splitting points of decimal conversion, and its Barrett
+         * reciprocal floor(B^(2n) / power) for B = 2^64 and n = power.size(), filled on first use.
+         */
+        struct power_of_ten {
+            limb_vector power, reciprocal;
+        };
+
+        /**
+         * Entry k of the table of powers, squaring up from 10^19 the first time. Each thread keeps
+         * its own table, so there is no locking; a deque, so entries stay put as it grows.
+         */
+        power_of_ten &powerOfTen(std::size_t k) {
+            thread_local std::deque<power_of_ten> table;
+            if (table.empty()) {
+                table.push_back({{chunkBase}, {}});
+            }
+            while (table.size() <= k) {
+                const limb_vector &last = table.back().power;
+                table.push_back({mulVectors(last, last), {}});
+            }
+            return table[k];
+        }
+
+        /**
+         * Newton's iteration for floor(B^(2n) / den) with n = den.size(), from a guess no larger
+         * than it: each step about doubles the correct digits and never overshoots.
+         */
+        limb_vector refineReciprocal(const limb_vector &den, limb_vector guess) {
+            std::size_t n = den.size();
+            limb_vector unit(2 * n + 1);
+            unit.back() = 1;
+            for (;;) {
+                limb_vector error = subMagnitudes(unit, mulVectors(den, guess));
+                if (compareMagnitudes(error, den) < 0) {
+                    return guess;
+                }
+                limb_vector step = shiftRight(mulVectors(guess, error), 128U * n);
+                guess = addMagnitudes(guess, step.empty() ? limb_vector{1} : step);
+            }
+        }
+
+        const limb_vector &reciprocalOf(std::size_t k) {
+            power_of_ten &entry = powerOfTen(k);
+            if (entry.reciprocal.empty()) {
+                if (k == 0) {
+                    limb_vector rem;
+                    divideMagnitudes({0, 0, 1}, entry.power, entry.reciprocal, rem);
+                } else {
+                    // The square of the previous reciprocal is right to about half the limbs.
+                    const limb_vector &last = reciprocalOf(k - 1);
+                    std::size_t excess = 4 * powerOfTen(k - 1).power.size() - 2 * entry.power.size();
+                    limb_vector guess = shiftRight(mulVectors(last, last), 64U * excess);
+                    entry.reciprocal = refineReciprocal(entry.power, std::move(guess));
+                }
+            }
+            return entry.reciprocal;
+        }
+
+        /**
+         * quot = value / 10^(19 * 2^k) and rem = value % 10^(19 * 2^k) for value < 10^(19 * 2^(k + 1)),
+         * by Barrett reduction: two multiplications and at most two corrections.
+         */
+        void divideByPower(const limb_vector &value, std::size_t k, limb_vector &quot, limb_vector &rem) {
+            const limb_vector &power = powerOfTen(k).power;
+            std::size_t n = power.size();
+            quot = shiftRight(mulVectors(shiftRight(value, 64U * (n - 1)), reciprocalOf(k)), 64U * (n + 1));
+            rem = subMagnitudes(value, mulVectors(quot, power));
+            while (compareMagnitudes(rem, power) >= 0) {
+                rem = subMagnitudes(rem, power);
+                quot = addMagnitudes(quot, {1});
+            }
+        }
+
+        /** Appends the digits of value 19 at a time, zero-padded to width digits (0: not padded). */
+        void appendChunks(limb_vector value, std::size_t width, std::string &text) {
+            // The chunks come out least significant first.
+            std::vector<limb> chunks;
+            while (!value.empty()) {
+                chunks.push_back(divideByLimb(value, chunkBase));
+            }
+            std::size_t count = chunks.size();
+            if (width != 0) {
+                text.append(width - count * chunkDigits, '0');
+            } else if (count != 0) {
+                text += std::to_string(chunks[--count]);
+            }
+            for (std::size_t i = count; i-- > 0;) {
+                char digits[chunkDigits];
+                limb chunk = chunks[i];
+                for (int j = chunkDigits - 1; j >= 0; --j) {
+                    digits[j] = static_cast<char>('0' + chunk % 10U);
+                    chunk /= 10U;
+                }
+                text.append(digits, chunkDigits);
+            }
+        }
+
+        /**
+         * Appends the digits of value < 10^(19 * 2^(k + 1)), zero-padded to all 19 * 2^(k + 1) of
+         * them when pad, as the digits of the quotient and remainder by 10^(19 * 2^k).
+         */
+        void appendDecimal(const limb_vector &value, std::size_t k, bool pad, std::string &text) {
+            if (value.size() < radixBase) {
+                appendChunks(value, pad ? std::size_t{chunkDigits} << (k + 1) : 0, text);
+                return;
+            }
+            limb_vector quot, rem;
+            divideByPower(value, k, quot, rem);
+            if (pad || !quot.empty()) {
+                appendDecimal(quot, k - 1, pad, text);
+                pad = true;
+            }
+            appendDecimal(rem, k - 1, pad, text);
+        }
+
+        /** The value of the decimal digits [first, last), split at the cached powers when long. */
+        limb_vector parseDecimal(const char *first, const char *last) {
+            auto length = static_cast<std::size_t>(last - first);
+            limb_vector result;
+            if (length < radixBase * chunkDigits) {
+                // The first chunk takes the odd digits so the others are all 19 long.
+                std::size_t chunk = length % chunkDigits == 0 ? chunkDigits : length % chunkDigits;
+                for (const char *start = first; start != last; start += chunk, chunk = chunkDigits) {
+                    limb part = 0, scale = 1;
+                    for (std::size_t i = 0; i < chunk; ++i) {
+                        part = part * 10U + static_cast<limb>(start[i] - '0');
+                        scale *= 10U;
+                    }
+                    mulAddLimb(result, scale, part);
+                }
+                trimLimbs(result);
+                return result;
+            }
+            // high * 10^(19 * 2^k) + low, with low the largest such run of digits shorter than the whole.
+            std::size_t k = 0;
+            while (std::size_t{chunkDigits} << (k + 1) < length) {
+                ++k;
+            }
+            const char *split = last - (std::size_t{chunkDigits} << k);
+            limb_vector high = parseDecimal(first, split);
+            result = addMagnitudes(mulVectors(high, powerOfTen(k).power), parseDecimal(split, last));
+            return result;
+        }
+    }
+
+    BigInt::tuning_override::tuning_override(const tuning &values) noexcept : _saved(activeTuning) {
+        activeTuning = values;
+    }
+
+    BigInt::tuning_override::~tuning_override() {
+        activeTuning = _saved;
+    }
+
+    std::size_t BigInt::bit_width() const noexcept {
+        return bitWidthOf(_limbs);
+    }
+
+    std::size_t BigInt::trailing_zeros() const noexcept {
+        for (std::size_t i = 0; i < _limbs.size(); ++i) {
+            if (_limbs[i] != 0) {
+                return 64U * i + static_cast<std::size_t>(std::countr_zero(_limbs[i]));
+            }
+        }
+        return 0;
+    }
+
+    BigInt BigInt::abs() const {
+        BigInt result = *this;
+        result._negative = false;
+        return result;
+    }
+
+    void BigInt::trim() noexcept {
+        trimLimbs(_limbs);
+        if (_limbs.empty()) {
+            _negative = false;
+        }
+    }
+
+    std::string BigInt::to_string() const {
+        if (_limbs.empty()) {
+            return "0";
+        }
+        std::string text = _negative ? "-" : "";
+        if (_limbs.size() < radixBase) {
+            appendChunks(_limbs, 0, text);
+            return text;
+        }
+        // Split at the first power whose square is surely above the value.
+        std::size_t k = 0;
+        while (2 * (powerOfTen(k).power.size() - 1) < _limbs.size()) {
+            ++k;
+        }
+        appendDecimal(_limbs, k, false, text);
+        return text;
+    }
+
+    std::from_chars_result from_chars(const char *first, const char *last, BigInt &value) {
+        const char *pos = first;
+        bool negative = pos != last && *pos == '-';
+        if (negative) {
+            ++pos;
+        }
+        const char *digits = pos;
+        while (pos != last && static_cast<unsigned>(*pos - '0') < 10U) {
+            ++pos;
+        }
+        if (pos == digits) {
+            return {first, std::errc::invalid_argument};
+        }
+        BigInt result;
+        result._limbs = parseDecimal(digits, pos);
+        result._negative = negative;
+        result.trim();
+        value = std::move(result);
+        return {pos, std::errc{}};
+    }
+
+    BigInt operator+(const BigInt &_n1, const BigInt &_n2) {
+        BigInt result;
+        if (_n1._negative == _n2._negative) {
+            result._limbs = addMagnitudes(_n1._limbs, _n2._limbs);
+            result._negative = _n1._negative;
+        } else if (compareMagnitudes(_n1._limbs, _n2._limbs) >= 0) {
+            result._limbs = subMagnitudes(_n1._limbs, _n2._limbs);
+            result._negative = _n1._negative;
+        } else {
+            result._limbs = subMagnitudes(_n2._limbs, _n1._limbs);
+            result._negative = _n2._negative;
+        }
+        result.trim();
+        return result;
+    }
+
+    BigInt operator-(const BigInt &_n1, const BigInt &_n2) {
+        return _n1 + -_n2;
+    }
+
+    BigInt operator*(const BigInt &_n1, const BigInt &_n2) {
+        BigInt result;
+        result._limbs = mulMagnitudes(_n1._limbs, _n2._limbs);
+        result._negative = _n1._negative != _n2._negative;
+        result.trim();
+        return result;
+    }
+
+    BigInt operator/(const BigInt &_n1, const BigInt &_n2) {
+        return BigInt::divmod(_n1, _n2).first;
+    }
+
+    BigInt operator%(const BigInt &_n1, const BigInt &_n2) {
+        return BigInt::divmod(_n1, _n2).second;
+    }
+
+    BigInt BigInt::operator-() const {
+        BigInt result = *this;
+        result._negative = !_negative && !_limbs.empty();
+        return result;
+    }
+
+    BigInt &BigInt::operator+=(const BigInt &_n) {
+        return *this = *this + _n;
+    }
+
+    BigInt &BigInt::operator-=(const BigInt &_n) {
+        return *this = *this - _n;
+    }
+
+    BigInt &BigInt::operator*=(const BigInt &_n) {
+        return *this = *this * _n;
+    }
+
+    BigInt &BigInt::operator/=(const BigInt &_n) {
+        return *this = *this / _n;
+    }
+
+    BigInt &BigInt::operator%=(const BigInt &_n) {
+        return *this = *this % _n;
+    }
+
+    BigInt BigInt::operator<<(std::size_t bits) const {
+        BigInt result;
+        result._limbs = shiftLeft(_limbs, bits);
+        result._negative = _negative;
+        result.trim();
+        return result;
+    }
+
+    BigInt BigInt::operator>>(std::size_t bits) const {
+        BigInt result;
+        result._limbs = shiftRight(_limbs, bits);
+        result._negative = _negative;
+        result.trim();
+        return result;
+    }
+
+    std::pair<BigInt, BigInt> BigInt::divmod(const BigInt &_n1, const BigInt &_n2) {
+        if (_n2.is_zero()) {
+            throw std::overflow_error("ARITHMETIC ERROR: Can not divide by 0!");
+        }
+        std::pair<BigInt, BigInt> result;
+        divideMagnitudes(_n1._limbs, _n2._limbs, result.first._limbs, result.second._limbs);
+        result.first._negative = _n1._negative != _n2._negative;
+        result.second._negative = _n1._negative;
+        result.first.trim();
+        result.second.trim();
+        return result;
+    }
+
+    BigInt BigInt::divexact(const BigInt &_n1, const BigInt &_n2) {
+        if (_n2.is_zero()) {
+            throw std::overflow_error("ARITHMETIC ERROR: Can not divide by 0!");
+        }
+        BigInt result;
+        result._limbs = divideExact(_n1._limbs, _n2._limbs);
+        result._negative = _n1._negative != _n2._negative;
+        result.trim();
+        return result;
+    }
+
+    BigInt gcd(const BigInt &_n1, const BigInt &_n2) {
+        limb_vector x = _n1._limbs, y = _n2._limbs;
+        if (compareMagnitudes(x, y) < 0) {
+            std::swap(x, y);
+        }
+        bool halving = true;
+        while (y.size() > 2) {
+            if (halving && y.size() >= activeTuning.half_gcd) {
+                // Takes y down to half the bits of x; the Euclid step below then goes past it.
+                std::size_t width = bitWidthOf(x);
+                halfGcd(x, y, nullptr);
+                // Cannot happen with exact steps, but would otherwise loop forever.
+                halving = bitWidthOf(x) < width || bitWidthOf(y) <= width / 2 + 1;
+            } else {
+                // Lehmer: run Euclid on the leading 62 bits and apply the cofactors to the full values.
+                lehmer_step step = lehmerCofactors(x, y);
+                if (step.b != 0) {
+                    lehmerUpdate(x, y, step, nullptr);
+                    continue;
+                }
+            }
+            if (!y.empty()) {
+                euclidStep(x, y);
+            }
+        }
+        BigInt result;
+        if (y.empty()) {
+            result._limbs = std::move(x);
+            return result;
+        }
+        if (x.size() > 2) {
+            euclidStep(x, y);
+        }
+        for (wide value = binaryGcd(toWide(x), toWide(y)); value != 0; value >>= 64U) {
+            result._limbs.push_back(static_cast<limb>(value));
+        }
+        return result;
+    }
+
+    std::strong_ordering operator<=>(const BigInt &_n1, const BigInt &_n2) noexcept {
+        if (_n1._negative != _n2._negative) {
+            return _n1._negative ? std::strong_ordering::less : std::strong_ordering::greater;
+        }
+        int order = compareMagnitudes(_n1._limbs, _n2._limbs);
+        if (_n1._negative) {
+            order = -order;
+        }
+        return order <=> 0;
+    }
+
+    std::ostream &operator<<(std::ostream &output, const BigInt &_n) {
+        std::string text = _n.to_string();
+        return output.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+}
@@ -0,0 +1,206 @@
+#ifndef BIG_INT_HPP
+#define BIG_INT_HPP
+
+#include <charconv>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "FractionMath.hpp"
+
+namespace ariel {
+    /**
+     * Arbitrary-precision signed integer, the numerator and denominator type of BigFraction.
+     * Stored as a sign and a magnitude in 64-bit limbs, least significant first, with no leading
+     * zero limbs (zero has no limbs and is never negative).
+     */
+    class BigInt {
+        std::vector<std::uint64_t> _limbs;
+        bool _negative = false;
+
+    public:
+        /**
+         * Operand sizes, in limbs, from which multiplication switches from schoolbook to Karatsuba
+         * and from Karatsuba to Toom-3 (squares have their own pair), and from which gcd() switches
+         * from Lehmer's algorithm to half-gcd. default_tuning was measured with Benchmark.cpp on
+         * x86-64.
+         */
+        struct tuning {
+            std::size_t karatsuba = 32, toom3 = 256, karatsuba_square = 48, toom3_square = 384;
+            std::size_t half_gcd = 768;
+        };
+
+        static const tuning default_tuning;
+
+        /**
+         * For tests and benchmarks: while it lives, multiplication and gcd() on the calling thread
+         * use other sizes than default_tuning. The destructor puts back the sizes that were in
+         * effect before, so overrides nest and an exception cannot leave one behind.
+         */
+        class tuning_override {
+            tuning _saved;
+
+        public:
+            explicit tuning_override(const tuning &values) noexcept;
+
+            ~tuning_override();
+
+            tuning_override(const tuning_override &) = delete;
+
+            tuning_override &operator=(const tuning_override &) = delete;
+        };
+
+        BigInt() = default;
+
+        template<fraction_integer I>
+        BigInt(I n) : _negative(n < 0) {
+            auto value = static_cast<unsigned __int128>(magnitude(n));
+            for (; value != 0; value >>= 64U) {
+                _limbs.push_back(static_cast<std::uint64_t>(value));
+            }
+        }
+
+        bool is_zero() const noexcept { return _limbs.empty(); }
+
+        bool is_negative() const noexcept { return _negative; }
+
+        /** -1, 0 or 1. */
+        int sign() const noexcept { return _negative ? -1 : (_limbs.empty() ? 0 : 1); }
+
+        /** Number of bits of the magnitude (0 for zero). */
+        std::size_t bit_width() const noexcept;
+
+        /** Number of trailing zero bits of the magnitude (0 for zero). */
+        std::size_t trailing_zeros() const noexcept;
+
+        /** The magnitude limbs, least significant first. */
+        const std::vector<std::uint64_t> &limbs() const noexcept { return _limbs; }
+
+        BigInt abs() const;
+
+        /**
+         * The value as an I.
+         * @throw overflow_error when it does not fit.
+         */
+        template<fraction_integer I>
+        I to_int() const {
+            I result = 0;
+            if (!fits(result)) {
+                throw std::overflow_error("OVERFLOW ERROR!\n");
+            }
+            return result;
+        }
+
+        /**
+         * Stores the value in result when it fits in I.
+         * @return false (result unchanged) when it does not.
+         */
+        template<fraction_integer I>
+        bool fits(I &result) const noexcept {
+            if (_limbs.size() > 2) {
+                return false;
+            }
+            unsigned __int128 value = 0;
+            for (std::size_t i = _limbs.size(); i-- > 0;) {
+                value = value << 64U | _limbs[i];
+            }
+            auto limit = static_cast<unsigned __int128>(fraction_traits<I>::max) + (_negative ? 1U : 0U);
+            if (value > limit) {
+                return false;
+            }
+            using unsigned_type = typename fraction_traits<I>::unsigned_type;
+            auto low = static_cast<unsigned_type>(value);
+            result = static_cast<I>(_negative ? static_cast<unsigned_type>(0U - low) : low);
+            return true;
+        }
+
+        /**
+         * Decimal digits with a leading '-' when negative. Large values are split in halves at
+         * cached powers of 10 (both here and in from_chars()), so conversion costs a few
+         * multiplications rather than time quadratic in the length.
+         */
+        std::string to_string() const;
+
+        /**
+         * std::from_chars() for BigInt: an optionally '-'-signed run of decimal digits.
+         * @return errc::invalid_argument (and ptr == first) when there are no digits.
+         */
+        friend std::from_chars_result from_chars(const char *first, const char *last, BigInt &value);
+
+        // Arithmetic operations:
+        friend BigInt operator+(const BigInt &_n1, const BigInt &_n2);
+
+        friend BigInt operator-(const BigInt &_n1, const BigInt &_n2);
+
+        friend BigInt operator*(const BigInt &_n1, const BigInt &_n2);
+
+        /**
+         * Quotient truncated toward zero, like the built-in integers.
+         * @throw overflow_error when _n2 is 0.
+         */
+        friend BigInt operator/(const BigInt &_n1, const BigInt &_n2);
+
+        /**
+         * Remainder with the sign of _n1, like the built-in integers.
+         * @throw overflow_error when _n2 is 0.
+         */
+        friend BigInt operator%(const BigInt &_n1, const BigInt &_n2);
+
+        BigInt operator-() const;
+
+        BigInt &operator+=(const BigInt &_n);
+
+        BigInt &operator-=(const BigInt &_n);
+
+        BigInt &operator*=(const BigInt &_n);
+
+        BigInt &operator/=(const BigInt &_n);
+
+        BigInt &operator%=(const BigInt &_n);
+
+        /** Magnitude shifted left, sign kept. */
+        BigInt operator<<(std::size_t bits) const;
+
+        /** Magnitude shifted right (truncates toward zero), sign kept. */
+        BigInt operator>>(std::size_t bits) const;
+
+        /**
+         * Truncated quotient and remainder of _n1 / _n2 in one division.
+         * @throw overflow_error when _n2 is 0.
+         */
+        static std::pair<BigInt, BigInt> divmod(const BigInt &_n1, const BigInt &_n2);
+
+        /**
+         * _n1 / _n2 for a _n2 known to divide _n1, as reduction needs: Jebelean's exact division,
+         * which finds the quotient from the low limbs up with one multiplication per limb and
+         * never forms a remainder. The result is meaningless when _n2 does not divide _n1.
+         * @throw overflow_error when _n2 is 0.
+         */
+        static BigInt divexact(const BigInt &_n1, const BigInt &_n2);
+
+        /**
+         * Greatest common divisor of |_n1| and |_n2| (0 when both are 0): half-gcd for large
+         * values, then Lehmer's algorithm.
+         */
+        friend BigInt gcd(const BigInt &_n1, const BigInt &_n2);
+
+        // Comparison operations:
+        friend bool operator==(const BigInt &_n1, const BigInt &_n2) = default;
+
+        friend std::strong_ordering operator<=>(const BigInt &_n1, const BigInt &_n2) noexcept;
+
+        // I/O operations:
+        friend std::ostream &operator<<(std::ostream &output, const BigInt &_n);
+
+    private:
+        /** Drops leading zero limbs, and the sign of zero. */
+        void trim() noexcept;
+    };
+
+    inline constexpr BigInt::tuning BigInt::default_tuning{};
+}
+#endif
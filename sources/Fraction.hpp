@@ -1,120 +1,1977 @@
 #ifndef FRACTION_HPP
 #define FRACTION_HPP
 
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <compare>
+#include <concepts>
 #include <iostream>
+#include <iterator>
+#include <bit>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include "FractionMath.hpp"
+#include "FractionPolicies.hpp"
 
 using namespace std;
 namespace ariel {
-    class Fraction {
-        int _numerator, _denominator;
+    /**
+     * Text layouts for to_chars() and std::format(): "-3/2", the mixed number "-1 1/2", or the
+     * decimal "-1.50" with a given number of fraction digits.
+     */
+    enum class fraction_format { fraction, mixed, decimal };
+
+    /**
+     * Copies "n/d" or "n d" from input without interpreting it, passing each character to put and
+     * folding the whitespace between n and d to one space; put returns false when it has no room,
+     * and the character is then left in the stream. Characters are consumed as they are read, so
+     * the stream need not be seekable. Shared by the operator>> of basic_fraction and BigFraction.
+     * @return False when no separator followed n.
+     */
+    template<typename Put>
+    bool readFractionPair(istream &input, Put put) {
+        using traits = istream::traits_type;
+        istream::sentry ok(input); // skips leading whitespace
+        if (!ok) {
+            return false;
+        }
+        streambuf &buffer = *input.rdbuf();
+        auto isDigit = [](int c) { return c >= '0' && c <= '9'; };
+        auto copyNumber = [&](int c) {
+            if (c == '-' && put('-')) {
+                c = buffer.snextc();
+            }
+            while (isDigit(c) && put(static_cast<char>(c))) {
+                c = buffer.snextc();
+            }
+            return c;
+        };
+        int c = copyNumber(buffer.sgetc());
+        bool paired = false;
+        if (c == '/' && put('/')) {
+            c = copyNumber(buffer.snextc());
+            paired = true;
+        } else if (c != traits::eof() && isspace(c) && put(' ')) {
+            do {
+                c = buffer.snextc();
+            } while (c != traits::eof() && isspace(c));
+            c = copyNumber(c);
+            paired = true;
+        }
+        if (c == traits::eof()) {
+            input.setstate(ios::eofbit);
+        }
+        return paired;
+    }
+
+    /**
+     * Fraction of two IntT integers.
+     * Invariant: the denominator is positive and, under the default eager_reduce policy, the
+     * fraction is in reduced form. Every operation that builds a value establishes it, so copies
+     * and moves never re-reduce and the type is trivially copyable.
+     * Under lazy_reduce the gcd is deferred (see FractionPolicies.hpp); observers still see the
+     * reduced value.
+     * All arithmetic and comparisons are constexpr and defined in this header,
+     * so they can be inlined and evaluated at compile time.
+     * Overflow is checked against the range of IntT. An arithmetic result that does not fit is
+     * handed to OverflowPolicy (throw, saturate or wrap, see FractionPolicies.hpp); constructors,
+     * conversions and operator>> always throw.
+     */
+    template<fraction_integer IntT, typename ReducePolicy = eager_reduce, typename OverflowPolicy = throw_on_overflow>
+    class basic_fraction {
+        IntT _numerator, _denominator;
+
+        template<fraction_integer, typename, typename>
+        friend class basic_fraction;
 
     public:
-        Fraction();
+        using int_type = IntT;
+        using reduce_policy = ReducePolicy;
+        using overflow_policy = OverflowPolicy;
+
+        constexpr basic_fraction();
 
         /**
          * @throw invalid_argument when denominator is 0.
          */
-        Fraction(int numerator, int denominator);
+        constexpr basic_fraction(IntT numerator, IntT denominator);
 
-        Fraction(const Fraction &_frac);
+        constexpr basic_fraction(const basic_fraction &_frac) = default;
 
-        Fraction(Fraction &&_frac) noexcept;
+        constexpr basic_fraction(basic_fraction &&_frac) noexcept = default;
 
-        Fraction(const int &n);
+        /**
+         * Whole number n/1.
+         * @throw overflow_error when n does not fit in IntT.
+         */
+        template<fraction_integer I>
+        constexpr basic_fraction(I n);
 
-        Fraction(const double &dec);
+        /**
+         * The value truncated to 3 digits after the decimal point.
+         * @throw overflow_error when the value is not finite or does not fit.
+         */
+        basic_fraction(const double &dec);
 
-        Fraction(const float &flt);
+        basic_fraction(const float &flt);
 
-        ~Fraction();
+        /**
+         * Same value under other policies.
+         */
+        template<typename OtherReduce, typename OtherOverflow>
+        constexpr explicit basic_fraction(const basic_fraction<IntT, OtherReduce, OtherOverflow> &_frac) noexcept;
 
-        int getNumerator();
+        constexpr ~basic_fraction() = default;
 
-        int getDenominator();
+        constexpr IntT getNumerator() const;
 
-        Fraction &operator=(const Fraction &_frac);
+        constexpr IntT getDenominator() const;
+
+        constexpr basic_fraction &operator=(const basic_fraction &_frac) = default;
+
+        constexpr basic_fraction &operator=(basic_fraction &&_frac) noexcept = default;
 
         // Arithmetic operations:
-        friend Fraction operator+(const Fraction &_frac1, const Fraction &_frac2);
+        friend constexpr basic_fraction operator+(const basic_fraction &_frac1, const basic_fraction &_frac2) {
+            return resolve(checked_add(_frac1, _frac2), _frac1, _frac2, '+');
+        }
+
+        friend constexpr basic_fraction operator-(const basic_fraction &_frac1, const basic_fraction &_frac2) {
+            return resolve(checked_sub(_frac1, _frac2), _frac1, _frac2, '-');
+        }
+
+        friend constexpr basic_fraction operator*(const basic_fraction &_frac1, const basic_fraction &_frac2) {
+            return resolve(checked_mul(_frac1, _frac2), _frac1, _frac2, '*');
+        }
 
-        friend Fraction operator-(const Fraction &_frac1, const Fraction &_frac2);
+        friend constexpr basic_fraction operator/(const basic_fraction &_frac1, const basic_fraction &_frac2) {
+            if (_frac2._numerator == 0) {
+                throw overflow_error("ARITHMETIC ERROR: Can not divide by 0!");
+            }
+            return resolve(checked_div(_frac1, _frac2), _frac1, _frac2, '/');
+        }
 
-        friend Fraction operator*(const Fraction &_frac1, const Fraction &_frac2);
+        // Mixed operations with an integer n that IntT holds exactly: no temporary fraction, and
+        // n/1 is already reduced, so sums need no gcd and products at most one.
+        template<narrower_integer<IntT> I>
+        friend constexpr basic_fraction operator+(const basic_fraction &_frac, I n) {
+            return resolve(addInteger(_frac, IntT(n), false, false), _frac, fromParts(IntT(n), 1), '+');
+        }
 
-        friend Fraction operator/(const Fraction &_frac1, const Fraction &_frac2);
+        template<narrower_integer<IntT> I>
+        friend constexpr basic_fraction operator+(I n, const basic_fraction &_frac) {
+            return _frac + n;
+        }
 
+        template<narrower_integer<IntT> I>
+        friend constexpr basic_fraction operator-(const basic_fraction &_frac, I n) {
+            return resolve(addInteger(_frac, IntT(n), true, false), _frac, fromParts(IntT(n), 1), '-');
+        }
 
-        Fraction &operator+=(const Fraction &_frac);
+        template<narrower_integer<IntT> I>
+        friend constexpr basic_fraction operator-(I n, const basic_fraction &_frac) {
+            return resolve(addInteger(_frac, IntT(n), true, true), fromParts(IntT(n), 1), _frac, '-');
+        }
 
-        Fraction &operator-=(const Fraction &_frac);
+        template<narrower_integer<IntT> I>
+        friend constexpr basic_fraction operator*(const basic_fraction &_frac, I n) {
+            return resolve(mulInteger(_frac, IntT(n)), _frac, fromParts(IntT(n), 1), '*');
+        }
 
-        Fraction &operator*=(const Fraction &_frac);
+        template<narrower_integer<IntT> I>
+        friend constexpr basic_fraction operator*(I n, const basic_fraction &_frac) {
+            return _frac * n;
+        }
 
-        Fraction &operator++();
+        template<narrower_integer<IntT> I>
+        friend constexpr basic_fraction operator/(const basic_fraction &_frac, I n) {
+            if (n == 0) {
+                throw overflow_error("ARITHMETIC ERROR: Can not divide by 0!");
+            }
+            return resolve(divInteger(_frac, IntT(n)), _frac, fromParts(IntT(n), 1), '/');
+        }
 
-        Fraction operator++(int);
+        template<narrower_integer<IntT> I>
+        friend constexpr basic_fraction operator/(I n, const basic_fraction &_frac) {
+            if (_frac._numerator == 0) {
+                throw overflow_error("ARITHMETIC ERROR: Can not divide by 0!");
+            }
+            return resolve(integerOver(IntT(n), _frac), fromParts(IntT(n), 1), _frac, '/');
+        }
 
-        Fraction &operator--();
+        // Non-throwing arithmetic: empty result on overflow (or division by 0) instead of an exception.
+        // The operands are cross-cancelled first (Knuth, TAOCP 4.5.1) and sums are formed in the wider
+        // type, so only a reduced result that really does not fit in IntT is reported as overflow.
+        // Under lazy_reduce the plain cross products are tried first, and the operands are only
+        // reduced when that overflows.
+        friend constexpr optional<basic_fraction> checked_add(const basic_fraction &_frac1,
+                                                              const basic_fraction &_frac2) noexcept {
+            if constexpr (ReducePolicy::lazy) {
+                if (auto result = combineUnreduced(_frac1, _frac2, '+')) {
+                    return result;
+                }
+            }
+            basic_fraction rhs = _frac2.reduced();
+            return addScaled(_frac1.reduced(), rhs._numerator, rhs._denominator, false);
+        }
 
-        Fraction operator--(int);
+        friend constexpr optional<basic_fraction> checked_sub(const basic_fraction &_frac1,
+                                                              const basic_fraction &_frac2) noexcept {
+            if constexpr (ReducePolicy::lazy) {
+                if (auto result = combineUnreduced(_frac1, _frac2, '-')) {
+                    return result;
+                }
+            }
+            basic_fraction rhs = _frac2.reduced();
+            return addScaled(_frac1.reduced(), rhs._numerator, rhs._denominator, true);
+        }
 
-        Fraction operator-() const;
+        friend constexpr optional<basic_fraction> checked_mul(const basic_fraction &_frac1,
+                                                              const basic_fraction &_frac2) noexcept {
+            if constexpr (ReducePolicy::lazy) {
+                if (auto result = combineUnreduced(_frac1, _frac2, '*')) {
+                    return result;
+                }
+            }
+            basic_fraction lhs = _frac1.reduced(), rhs = _frac2.reduced();
+            return mulReduced(lhs._numerator, lhs._denominator, rhs._numerator, rhs._denominator);
+        }
+
+        friend constexpr optional<basic_fraction> checked_div(const basic_fraction &_frac1,
+                                                              const basic_fraction &_frac2) noexcept {
+            if (_frac2._numerator == 0) {
+                return nullopt;
+            }
+            if constexpr (ReducePolicy::lazy) {
+                if (auto result = combineUnreduced(_frac1, _frac2, '/')) {
+                    return result;
+                }
+            }
+            basic_fraction lhs = _frac1.reduced(), rhs = _frac2.reduced();
+            return mulReduced(lhs._numerator, lhs._denominator, rhs._denominator, rhs._numerator);
+        }
+
+        friend constexpr optional<basic_fraction> checked_increment(const basic_fraction &_frac) noexcept {
+            return addOne(_frac, false);
+        }
+
+        friend constexpr optional<basic_fraction> checked_decrement(const basic_fraction &_frac) noexcept {
+            return addOne(_frac, true);
+        }
+
+        /**
+         * Non-throwing versions of the double and float constructors.
+         * @return Empty when the value is not finite or does not fit in IntT.
+         */
+        static optional<basic_fraction> checked_from(double dec) noexcept;
+
+        static optional<basic_fraction> checked_from(float flt) noexcept;
+
+        /**
+         * The exact value of a double or float: its binary mantissa over a power of two, taken
+         * from the IEEE bits without any floating point arithmetic.
+         * @return Empty when the value is not finite or its numerator or denominator does not fit.
+         */
+        template<floating_point F>
+        static constexpr optional<basic_fraction> checked_from_exact(F x) noexcept;
+
+        /**
+         * @throw overflow_error when checked_from_exact() is empty.
+         */
+        template<floating_point F>
+        static constexpr basic_fraction from_exact(F x);
+
+        /**
+         * x rounded to the nearest multiple of 10^-digits (ties away from zero), computed exactly
+         * from the IEEE bits with integer arithmetic only. Unlike the constructors, which keep
+         * floor(x * 1000) for compatibility, this rounds the exact value of x.
+         * @param digits In [0, 19], and 10^digits must fit in IntT.
+         * @return Empty when x is not finite, digits is out of range or the result does not fit.
+         */
+        template<floating_point F>
+        static constexpr optional<basic_fraction> checked_round_to_digits(F x, int digits) noexcept;
+
+        /**
+         * @throw overflow_error when checked_round_to_digits() is empty.
+         */
+        template<floating_point F>
+        static constexpr basic_fraction round_to_digits(F x, int digits);
+
+        /**
+         * The closest fraction to x with denominator at most max_den, found from the continued
+         * fraction of the exact value of x in O(log max_den) steps. Exact for |x| >= 2^-74;
+         * smaller values are first rounded to a multiple of 2^-127.
+         * @return Empty when x is not finite, max_den < 1 or the numerator does not fit.
+         */
+        static constexpr optional<basic_fraction> checked_from_double(double x, IntT max_den) noexcept;
+
+        /**
+         * @throw invalid_argument when max_den < 1.
+         * @throw overflow_error when x is not finite or the numerator does not fit.
+         */
+        static constexpr basic_fraction from_double(double x, IntT max_den);
+
+        /**
+         * from_double() of every element of values, written to the front of out.
+         * @throw invalid_argument when out is shorter than values or max_den < 1.
+         * @throw overflow_error on the first element that does not convert.
+         */
+        static void from_double(span<const double> values, span<basic_fraction> out, IntT max_den);
+
+        /**
+         * The closest fraction to this one with denominator at most max_den.
+         * @throw invalid_argument when max_den < 1.
+         */
+        constexpr basic_fraction limit_denominator(IntT max_den) const;
+
+        constexpr basic_fraction &operator+=(const basic_fraction &_frac);
+
+        constexpr basic_fraction &operator-=(const basic_fraction &_frac);
+
+        constexpr basic_fraction &operator*=(const basic_fraction &_frac);
+
+        constexpr basic_fraction &operator++();
+
+        constexpr basic_fraction operator++(int);
+
+        constexpr basic_fraction &operator--();
+
+        constexpr basic_fraction operator--(int);
+
+        constexpr basic_fraction operator-() const;
 
         // Boolean operations:
-        bool operator!() const;
+        constexpr bool operator!() const;
 
-        friend bool operator!=(const Fraction &_frac1, const Fraction &_frac2);
+        /**
+         * Exact equality. Reduced values are unique, so eagerly reduced fractions need only two
+         * integer compares; lazily reduced ones compare by cross multiplication.
+         */
+        friend constexpr bool operator==(const basic_fraction &_frac1, const basic_fraction &_frac2) {
+            if constexpr (ReducePolicy::lazy) {
+                return (_frac1 <=> _frac2) == 0;
+            } else {
+                return ((_frac1._numerator ^ _frac2._numerator) | (_frac1._denominator ^ _frac2._denominator)) == 0;
+            }
+        }
 
-        friend bool operator==(const Fraction &_frac1, const Fraction &_frac2);
+        friend constexpr bool operator!=(const basic_fraction &_frac1, const basic_fraction &_frac2) {
+            return !(_frac1 == _frac2);
+        }
 
-        friend bool operator>=(const Fraction &_frac1, const Fraction &_frac2);
+        /**
+         * Comparing with a floating point value is inherently inexact, so it keeps the
+         * 0.001 tolerance of approx_equal(). Also used for `dec == frac` by C++20 rewriting.
+         */
+        template<floating_point F>
+        friend bool operator==(const basic_fraction &_frac, F dec) {
+            return approx_equal(_frac, static_cast<double>(dec));
+        }
 
-        friend bool operator<=(const Fraction &_frac1, const Fraction &_frac2);
+        /**
+         * Tolerant equality: true when the two values differ by less than eps.
+         * Use operator== for exact equality.
+         */
+        friend bool approx_equal(const basic_fraction &_frac1, const basic_fraction &_frac2, double eps = 0.001) {
+            return approx_equal(_frac1, _frac2.to_double(), eps);
+        }
 
-        friend bool operator<(const Fraction &_frac1, const Fraction &_frac2);
+        friend bool approx_equal(const basic_fraction &_frac, double dec, double eps = 0.001) {
+            double value = _frac.to_double();
+            return (value == dec || abs(value - dec) < eps);
+        }
 
-        friend bool operator>(const Fraction &_frac1, const Fraction &_frac2);
+        /**
+         * Exact three-way comparison: compares num1*den2 with num2*den1 in a type twice as wide,
+         * so no floating point is involved and no rounding can make close values tie.
+         * Types without a wider type compare their continued fraction expansions instead.
+         */
+        friend constexpr strong_ordering operator<=>(const basic_fraction &_frac1, const basic_fraction &_frac2) {
+            using wide_type = typename fraction_traits<IntT>::wide_type;
+            if constexpr (is_void_v<wide_type>) {
+                return compareExpansions(_frac1._numerator, _frac1._denominator,
+                                         _frac2._numerator, _frac2._denominator);
+            } else {
+                // Denominators are always positive, so cross multiplication keeps the order.
+                return static_cast<wide_type>(_frac1._numerator) * _frac2._denominator <=>
+                       static_cast<wide_type>(_frac2._numerator) * _frac1._denominator;
+            }
+        }
+
+        /**
+         * Ordering against an integer without converting it; also gives n < frac and the rest
+         * through C++20 rewriting.
+         */
+        template<narrower_integer<IntT> I>
+        friend constexpr strong_ordering operator<=>(const basic_fraction &_frac, I n) {
+            using wide_type = typename fraction_traits<IntT>::wide_type;
+            if constexpr (is_void_v<wide_type>) {
+                // frac == q + r/den with 0 <= r < den, so it is past n exactly when q > n or q == n < frac.
+                IntT q = _frac._numerator / _frac._denominator - (_frac._numerator % _frac._denominator < 0 ? 1 : 0);
+                if (q != n) {
+                    return q <=> IntT(n);
+                }
+                return _frac._numerator % _frac._denominator != 0 ? strong_ordering::greater : strong_ordering::equal;
+            } else {
+                return static_cast<wide_type>(_frac._numerator) <=> static_cast<wide_type>(n) * _frac._denominator;
+            }
+        }
+
+        template<narrower_integer<IntT> I>
+        friend constexpr bool operator==(const basic_fraction &_frac, I n) {
+            if constexpr (ReducePolicy::lazy) {
+                return (_frac <=> n) == 0;
+            } else {
+                return _frac._denominator == 1 && _frac._numerator == n;
+            }
+        }
+
+        friend constexpr bool operator>=(const basic_fraction &_frac1, const basic_fraction &_frac2) {
+            return (_frac1 <=> _frac2) >= 0;
+        }
+
+        friend constexpr bool operator<=(const basic_fraction &_frac1, const basic_fraction &_frac2) {
+            return (_frac1 <=> _frac2) <= 0;
+        }
+
+        friend constexpr bool operator<(const basic_fraction &_frac1, const basic_fraction &_frac2) {
+            return (_frac1 <=> _frac2) < 0;
+        }
+
+        friend constexpr bool operator>(const basic_fraction &_frac1, const basic_fraction &_frac2) {
+            return (_frac1 <=> _frac2) > 0;
+        }
 
         // Conversions:
+        /**
+         * Correctly rounded value (round to nearest, ties to even). When both parts are exact in
+         * a double this is one division; otherwise it falls back to integer long division.
+         */
+        double to_double() const noexcept;
+
+        float to_float() const noexcept;
+
+        /**
+         * The value rounded to the given number of decimal places, as operator double used to
+         * return it (5 places).
+         */
+        double to_rounded_double(int decimals = 5) const;
+
+        /**
+         * to_double() / to_float() of every element of values, written to the front of out.
+         * @throw invalid_argument when out is shorter than values.
+         */
+        static void to_double(span<const basic_fraction> values, span<double> out);
+
+        static void to_float(span<const basic_fraction> values, span<float> out);
+
+        /** Same as to_double(). */
         explicit operator double() const;
 
+        /** Same as to_float(). */
         explicit operator float() const;
 
-        // I/O operations:
-        friend std::ostream &operator<<(ostream &output, const Fraction &_frac);
+        /**
+         * Parses the whole of text as from_chars() does. Allocates nothing and does not use iostreams.
+         * @return Empty when text is not exactly one number in the given format, or it does not fit.
+         */
+        static optional<basic_fraction> parse(string_view text,
+                                              fraction_format format = fraction_format::fraction) noexcept;
+
+        /**
+         * std::from_chars() for fractions: reads "n/d", "n d" (spaces or tabs between) or a plain
+         * integer n from the front of [first, last), with n and d decimal and optionally '-'-signed.
+         * With fraction_format::mixed it reads "-w n/d", "-n/d" or "-w" instead (the sign applies to
+         * the whole value), and with fraction_format::decimal the exact value of a decimal literal:
+         * "-12.5", ".5", "1e-7", "2.5E+3" or "0.1(6)", a repeating block in parentheses.
+         * No floating point is involved; decimals with more than 38 significant digits are out of range.
+         * @return ptr past the parsed text; on error value is left unchanged and ec is
+         * errc::invalid_argument when there is no number at first, errc::argument_out_of_domain
+         * when the denominator is 0 and errc::result_out_of_range when a part does not fit.
+         */
+        template<fraction_integer I, typename R, typename O>
+        friend from_chars_result from_chars(const char *first, const char *last, basic_fraction<I, R, O> &value,
+                                            fraction_format format) noexcept;
+
+        /**
+         * std::to_chars() for fractions: writes the value in lowest terms in the given format,
+         * with precision digits after the point for fraction_format::decimal (rounded half to
+         * even). Allocates nothing.
+         * @return ptr past the written text; errc::value_too_large (and ptr == last) when
+         * [first, last) is too short, errc::invalid_argument when precision is negative.
+         */
+        template<fraction_integer I, typename R, typename O>
+        friend to_chars_result to_chars(char *first, char *last, const basic_fraction<I, R, O> &value,
+                                        fraction_format format, int precision) noexcept;
 
-        friend std::istream &operator>>(istream &input, Fraction &_frac);
+        /**
+         * The decimal expansion of value rounded half to even to at most digits places, without
+         * trailing zeros ("0.125", "0.33333"). With repeating set, an expansion whose repeating
+         * block ends within digits places is written exactly in the notation parse() reads:
+         * "0.1(6)". The period is the multiplicative order of 10 modulo the part of the reduced
+         * denominator coprime to 10, searched only up to the digit budget.
+         * @throw invalid_argument when digits is negative.
+         */
+        template<fraction_integer I, typename R, typename O>
+        friend string to_decimal(const basic_fraction<I, R, O> &value, int digits, bool repeating);
 
-        Fraction &operator=(Fraction &&_frac) noexcept;
+        // I/O operations:
+        /** Writes "n/d" in lowest terms with a single write(). */
+        friend std::ostream &operator<<(ostream &output, const basic_fraction &_frac) {
+            char text[2 * (fraction_traits<IntT>::digits / 3 + 2)];
+            to_chars_result result = to_chars(text, std::end(text), _frac);
+            return output.write(text, result.ptr - text);
+        }
+
+        /**
+         * Reads "n d" or "n/d" (n and d decimal, optionally '-'-signed) through from_chars().
+         * The denominator is required here, so a lone integer is rejected. Characters are consumed
+         * as they are read, so the stream need not be seekable; nothing is put back on error.
+         * @throw runtime_error (after setting failbit) when the input is not such a pair or the
+         * denominator is 0.
+         */
+        friend std::istream &operator>>(istream &input, basic_fraction &_frac) {
+            // Two IntT values in decimal, their signs and the separator.
+            char text[2 * (fraction_traits<IntT>::digits * 30103 / 100000 + 2) + 1];
+            char *end = text;
+            bool paired = readFractionPair(input, [&](char c) {
+                if (end == std::end(text)) {
+                    return false;
+                }
+                *end++ = c;
+                return true;
+            });
+            from_chars_result result = from_chars(text, end, _frac);
+            if (!paired || result.ec != errc{} || result.ptr != end) {
+                input.setstate(ios::failbit);
+                if (result.ec == errc::argument_out_of_domain) {
+                    throw runtime_error("RUNTIME ERROR: Denominator can not be 0!\n");
+                }
+                throw runtime_error("RUNTIME ERROR: Expected a fraction \"n d\" or \"n/d\"!\n");
+            }
+            return input;
+        }
 
     private:
         /**
          * Reduce the fraction to it's minimal form.
+         * @throw overflow_error when moving the sign to the numerator overflows.
+         */
+        constexpr void reducedForm();
+
+        /**
+         * Non-throwing reducedForm(). Under lazy_reduce only the sign is normalized, unless
+         * that overflows without reducing first.
+         * @return false when moving the sign to the numerator overflows.
+         */
+        constexpr bool normalize() noexcept;
+
+        /**
+         * This value in lowest terms (a no-op under eager_reduce).
+         */
+        constexpr basic_fraction reduced() const noexcept;
+
+        /**
+         * _frac + n, or with subtract _frac - n (n - _frac when integerFirst), over the same
+         * denominator: gcd(num + n * den, den) == gcd(num, den), so no reduction is needed.
+         */
+        static constexpr optional<basic_fraction> addInteger(const basic_fraction &_frac, IntT n, bool subtract,
+                                                             bool integerFirst) noexcept;
+
+        /**
+         * _frac * n with the one gcd that can cancel, gcd(n, den).
+         */
+        static constexpr optional<basic_fraction> mulInteger(const basic_fraction &_frac, IntT n) noexcept;
+
+        /**
+         * _frac / n for n != 0, cancelling gcd(num, n).
+         */
+        static constexpr optional<basic_fraction> divInteger(const basic_fraction &_frac, IntT n) noexcept;
+
+        /**
+         * n / _frac for a non-zero _frac, cancelling gcd(n, num).
+         */
+        static constexpr optional<basic_fraction> integerOver(IntT n, const basic_fraction &_frac) noexcept;
+
+        /**
+         * Lazy fast path for _frac1 op _frac2 (op is one of + - * /) from the plain cross
+         * products. The result is reduced only when it is wider than 3/4 of the bits of IntT.
+         * @return Empty when a product overflows.
+         */
+        static constexpr optional<basic_fraction> combineUnreduced(const basic_fraction &_frac1,
+                                                                   const basic_fraction &_frac2, char op) noexcept;
+
+        /**
+         * _frac plus or minus 1. gcd(n + d, d) == gcd(n, d), so the result is reduced exactly when
+         * _frac is; under lazy_reduce _frac is reduced and retried only on overflow.
+         */
+        static constexpr optional<basic_fraction> addOne(const basic_fraction &_frac, bool subtract) noexcept;
+
+        /**
+         * num/den brought to reduced form; den must not be 0.
+         */
+        static constexpr optional<basic_fraction> makeReduced(IntT num, IntT den) noexcept;
+
+        /**
+         * num/den taken as is; the caller guarantees the class invariant.
+         */
+        static constexpr basic_fraction fromParts(IntT num, IntT den) noexcept;
+
+        /**
+         * _frac + num/den (or _frac - num/den), where num/den is reduced and den > 0.
+         * Multiplies by the LCM of the denominators rather than their product, and forms the
+         * numerator in fraction_traits<IntT>::wide_type when there is one.
+         */
+        static constexpr optional<basic_fraction> addScaled(const basic_fraction &_frac, IntT num, IntT den,
+                                                            bool subtract) noexcept;
+
+        /**
+         * (n1/d1) * (n2/d2) for reduced n1/d1 and n2/d2 (d2 may be negative, for division).
+         * Cancels gcd(n1, d2) and gcd(n2, d1) before multiplying, so the product is already reduced.
          */
-        void reducedForm();
+        static constexpr optional<basic_fraction> mulReduced(IntT n1, IntT d1, IntT n2, IntT d2) noexcept;
 
-        static istream &checkNextChar(istream &input, char expectedChar);
+        static constexpr basic_fraction valueOrThrow(const optional<basic_fraction> &result);
+
+        /**
+         * The result of _frac1 op _frac2 (op is one of + - * /), or what OverflowPolicy makes
+         * of it when result is empty because it did not fit.
+         */
+        static constexpr basic_fraction resolve(const optional<basic_fraction> &result, const basic_fraction &_frac1,
+                                                const basic_fraction &_frac2, char op);
+
+        /**
+         * floor(value * 1000) / 1000, the precision the double and float constructors keep.
+         */
+        static optional<basic_fraction> fromThousandths(double value) noexcept;
+
+        /**
+         * (-1)^negative * num / 10^digits, reduced without a general gcd.
+         * The caller checks that the numerator and 10^digits fit in IntT.
+         */
+        static constexpr basic_fraction overPowerOfTen(bool negative, typename fraction_traits<IntT>::unsigned_type num,
+                                                       int digits) noexcept;
+
+        /**
+         * num/den correctly rounded to F.
+         */
+        template<floating_point F>
+        static F quotient(IntT num, IntT den) noexcept;
+
+        /**
+         * Compare n1/d1 with n2/d2 (d1, d2 > 0) term by term of their continued fractions.
+         */
+        static constexpr strong_ordering compareExpansions(IntT n1, IntT d1, IntT n2, IntT d2);
+
+        /**
+         * from_chars() of a decimal literal, see there.
+         */
+        static from_chars_result decimalFromChars(const char *first, const char *last, basic_fraction &value) noexcept;
+
+        /**
+         * from_chars() of a mixed number, see there.
+         */
+        static from_chars_result mixedFromChars(const char *first, const char *last, basic_fraction &value) noexcept;
+
+        /**
+         * Stores (-1)^negative * num / den (in lowest terms, den > 0) in value and returns {end}, or
+         * returns errc::result_out_of_range when it does not fit.
+         */
+        static from_chars_result fromMagnitudes(bool negative, unsigned __int128 num, unsigned __int128 den,
+                                                const char *end, basic_fraction &value) noexcept;
 
     };
 
+    using Fraction = basic_fraction<int>;
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>::basic_fraction() : _numerator(0), _denominator(1) {}
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>::basic_fraction(IntT numerator, IntT denominator)
+            : _numerator(numerator), _denominator(denominator) {
+        if (denominator == 0) {
+            throw invalid_argument("INVALID ERROR: Denominator can not be 0!\n");
+        }
+        this->reducedForm();
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    template<fraction_integer I>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>::basic_fraction(I n)
+            : _numerator(static_cast<IntT>(n)), _denominator(1) {
+        if constexpr (fraction_traits<I>::digits > fraction_traits<IntT>::digits) {
+            if (n > static_cast<I>(fraction_traits<IntT>::max) || n < static_cast<I>(fraction_traits<IntT>::min)) {
+                throw overflow_error("OVERFLOW ERROR!\n");
+            }
+        }
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::basic_fraction(const double &dec)
+            : basic_fraction(valueOrThrow(checked_from(dec))) {}
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::basic_fraction(const float &flt)
+            : basic_fraction(valueOrThrow(checked_from(flt))) {}
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    template<typename OtherReduce, typename OtherOverflow>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>::basic_fraction(
+            const basic_fraction<IntT, OtherReduce, OtherOverflow> &_frac) noexcept
+            : _numerator(_frac.reduced()._numerator), _denominator(_frac.reduced()._denominator) {}
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr IntT basic_fraction<IntT, ReducePolicy, OverflowPolicy>::getNumerator() const {
+        return this->reduced()._numerator;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr IntT basic_fraction<IntT, ReducePolicy, OverflowPolicy>::getDenominator() const {
+        return this->reduced()._denominator;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    &basic_fraction<IntT, ReducePolicy, OverflowPolicy>::operator+=(const basic_fraction &_frac) {
+        return *this = resolve(checked_add(*this, _frac), *this, _frac, '+');
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    &basic_fraction<IntT, ReducePolicy, OverflowPolicy>::operator-=(const basic_fraction &_frac) {
+        return *this = resolve(checked_sub(*this, _frac), *this, _frac, '-');
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    &basic_fraction<IntT, ReducePolicy, OverflowPolicy>::operator*=(const basic_fraction &_frac) {
+        return *this = resolve(checked_mul(*this, _frac), *this, _frac, '*');
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    &basic_fraction<IntT, ReducePolicy, OverflowPolicy>::operator++() {
+        return *this = resolve(checked_increment(*this), *this, fromParts(1, 1), '+');
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::operator++(int) {
+        basic_fraction copy = *this;
+        *this = resolve(checked_increment(*this), *this, fromParts(1, 1), '+');
+        return copy;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    &basic_fraction<IntT, ReducePolicy, OverflowPolicy>::operator--() {
+        return *this = resolve(checked_decrement(*this), *this, fromParts(1, 1), '-');
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::operator--(int) {
+        basic_fraction copy = *this;
+        *this = resolve(checked_decrement(*this), *this, fromParts(1, 1), '-');
+        return copy;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::operator-() const {
+        // Only the minimum numerator fails to negate, and reducing may still save it.
+        basic_fraction value = this->_numerator == fraction_traits<IntT>::min ? this->reduced() : *this;
+        IntT num = 0;
+        if (subChecked(IntT(0), value._numerator, num)) {
+            return fromParts(num, value._denominator);
+        }
+        return resolve(nullopt, fromParts(0, 1), value, '-');
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr bool basic_fraction<IntT, ReducePolicy, OverflowPolicy>::operator!() const {
+        return this->_numerator == 0;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr void basic_fraction<IntT, ReducePolicy, OverflowPolicy>::reducedForm() {
+        if (!this->normalize()) {
+            throw overflow_error("OVERFLOW ERROR!\n");
+        }
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr bool basic_fraction<IntT, ReducePolicy, OverflowPolicy>::normalize() noexcept {
+        constexpr IntT min = fraction_traits<IntT>::min;
+        bool signFixOverflows = this->_denominator < 0 && (this->_numerator == min || this->_denominator == min);
+        if (!ReducePolicy::lazy || signFixOverflows) {
+            IntT d = gcdOf(this->_numerator, this->_denominator);
+            this->_numerator = this->_numerator / d;
+            this->_denominator = this->_denominator / d;
+        }
+        if (this->_denominator < 0) {
+            return subChecked(IntT(0), this->_numerator, this->_numerator) &&
+                   subChecked(IntT(0), this->_denominator, this->_denominator);
+        }
+        return true;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::reduced() const noexcept {
+        if constexpr (ReducePolicy::lazy) {
+            // The denominator is positive, so the gcd is too and the division cannot overflow.
+            IntT d = gcdOf(this->_numerator, this->_denominator);
+            return fromParts(this->_numerator / d, this->_denominator / d);
+        } else {
+            return *this;
+        }
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::addOne(const basic_fraction &_frac, bool subtract) noexcept {
+        IntT num = 0;
+        if (subtract ? subChecked(_frac._numerator, _frac._denominator, num)
+                     : addChecked(_frac._numerator, _frac._denominator, num)) {
+            return fromParts(num, _frac._denominator);
+        }
+        if constexpr (ReducePolicy::lazy) {
+            basic_fraction value = _frac.reduced();
+            if (value._denominator != _frac._denominator) {
+                return addOne(value, subtract);
+            }
+        }
+        return nullopt;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::addInteger(const basic_fraction &_frac, IntT n, bool subtract,
+                                                                   bool integerFirst) noexcept {
+        using wide_type = typename fraction_traits<IntT>::wide_type;
+        IntT num = 0;
+        bool fits = false;
+        if constexpr (is_void_v<wide_type>) {
+            IntT scaled = 0;
+            fits = mulChecked(n, _frac._denominator, scaled) &&
+                   (!subtract ? addChecked(_frac._numerator, scaled, num)
+                    : integerFirst ? subChecked(scaled, _frac._numerator, num)
+                    : subChecked(_frac._numerator, scaled, num));
+        } else {
+            // n * den and the sum fit in wide_type, so only the result can overflow.
+            wide_type scaled = static_cast<wide_type>(n) * _frac._denominator;
+            wide_type sum = !subtract ? _frac._numerator + scaled
+                          : integerFirst ? scaled - _frac._numerator
+                          : _frac._numerator - scaled;
+            fits = narrowChecked(sum, num);
+        }
+        if (fits) {
+            return fromParts(num, _frac._denominator);
+        }
+        basic_fraction value = _frac.reduced();
+        if constexpr (ReducePolicy::lazy) {
+            if (value._denominator != _frac._denominator) {
+                return addInteger(value, n, subtract, integerFirst);
+            }
+        }
+        if constexpr (is_void_v<wide_type>) {
+            // Only an intermediate may have overflowed; the general sum redoes it in double width.
+            return integerFirst ? addScaled(fromParts(n, 1), value._numerator, value._denominator, true)
+                                : addScaled(value, n, 1, subtract);
+        }
+        return nullopt;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::mulInteger(const basic_fraction &_frac, IntT n) noexcept {
+        IntT num = 0;
+        if constexpr (ReducePolicy::lazy) {
+            if (mulChecked(_frac._numerator, n, num)) {
+                return fromParts(n == 0 ? IntT(0) : num, n == 0 ? IntT(1) : _frac._denominator);
+            }
+        }
+        // The denominator is positive, so g is too and den / g stays positive.
+        basic_fraction value = _frac.reduced();
+        IntT g = gcdOf(n, value._denominator);
+        if (!mulChecked(value._numerator, IntT(n / g), num)) {
+            return nullopt;
+        }
+        return fromParts(num, value._denominator / g);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::divInteger(const basic_fraction &_frac, IntT n) noexcept {
+        if (_frac._numerator == 0) {
+            return basic_fraction();
+        }
+        // Lazy tries the plain product first, then reduces _frac and cancels like eager.
+        basic_fraction value = _frac;
+        for (bool cancel = !ReducePolicy::lazy;; cancel = true) {
+            IntT g = cancel ? gcdOf(value._numerator, n) : IntT(1);
+            IntT num = value._numerator / g, den = 0;
+            if (mulChecked(value._denominator, IntT(n / g), den) &&
+                (den > 0 || (subChecked(IntT(0), num, num) && subChecked(IntT(0), den, den)))) {
+                return fromParts(num, den);
+            }
+            if (cancel) {
+                return nullopt;
+            }
+            value = value.reduced();
+        }
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::integerOver(IntT n, const basic_fraction &_frac) noexcept {
+        if (n == 0) {
+            return basic_fraction();
+        }
+        // Same two passes as divInteger().
+        basic_fraction value = _frac;
+        for (bool cancel = !ReducePolicy::lazy;; cancel = true) {
+            IntT g = cancel ? gcdOf(n, value._numerator) : IntT(1);
+            IntT num = 0, den = value._numerator / g;
+            if (mulChecked(IntT(n / g), value._denominator, num) &&
+                (den > 0 || (subChecked(IntT(0), num, num) && subChecked(IntT(0), den, den)))) {
+                return fromParts(num, den);
+            }
+            if (cancel) {
+                return nullopt;
+            }
+            value = value.reduced();
+        }
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::combineUnreduced(const basic_fraction &_frac1,
+                                                                         const basic_fraction &_frac2,
+                                                                         char op) noexcept {
+        IntT n1 = _frac1._numerator, d1 = _frac1._denominator;
+        IntT n2 = _frac2._numerator, d2 = _frac2._denominator;
+        IntT num = 0, den = 0;
+        bool fits = true;
+        if (op == '+' || op == '-') {
+            IntT left = 0, right = 0;
+            fits = mulChecked(n1, d2, left) && mulChecked(n2, d1, right) &&
+                   (op == '+' ? addChecked(left, right, num) : subChecked(left, right, num)) &&
+                   mulChecked(d1, d2, den);
+        } else if (op == '*') {
+            fits = mulChecked(n1, n2, num) && mulChecked(d1, d2, den);
+        } else {
+            fits = mulChecked(n1, d2, num) && mulChecked(d1, n2, den);
+            if (fits && den < 0) {
+                fits = subChecked(IntT(0), num, num) && subChecked(IntT(0), den, den);
+            }
+        }
+        if (!fits) {
+            return nullopt;
+        }
+        basic_fraction result = fromParts(num, den);
+        // Past the threshold one gcd now restores the headroom, so the next products still fit.
+        constexpr int thresholdBits = fraction_traits<IntT>::digits * 3 / 4;
+        if (((magnitude(num) | magnitude(den)) >> thresholdBits) != 0) {
+            return result.reduced();
+        }
+        return result;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::makeReduced(IntT num, IntT den) noexcept {
+        basic_fraction result = fromParts(num, den);
+        if (!result.normalize()) {
+            return nullopt;
+        }
+        return result;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::fromParts(IntT num, IntT den) noexcept {
+        basic_fraction result;
+        result._numerator = num;
+        result._denominator = den;
+        return result;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::addScaled(const basic_fraction &_frac, IntT num,
+                                                                           IntT den, bool subtract) noexcept {
+        using wide_type = typename fraction_traits<IntT>::wide_type;
+        IntT d1 = gcdOf(_frac._denominator, den);
+        IntT sum = 0, d2 = 1, resultDen = 0;
+        if constexpr (is_void_v<wide_type>) {
+            IntT left = 0, right = 0;
+            if (mulChecked(_frac._numerator, IntT(den / d1), left) &&
+                mulChecked(num, IntT(_frac._denominator / d1), right) &&
+                (subtract ? subChecked(left, right, sum) : addChecked(left, right, sum))) {
+                if (d1 != 1) {
+                    // Any common factor of the sum and the denominators divides d1.
+                    d2 = gcdOf(sum, d1);
+                    sum /= d2;
+                }
+            } else {
+                // No wider type: redo the sum exactly in double width, so again only the reduced
+                // numerator can overflow.
+                double_width<IntT> rightFull = mulFull(num, IntT(_frac._denominator / d1));
+                rightFull.negative = subtract != rightFull.negative && (rightFull.high | rightFull.low) != 0;
+                double_width<IntT> wideSum = addFull(mulFull(_frac._numerator, IntT(den / d1)), rightFull);
+                if (d1 != 1) {
+                    IntT rem = 0;
+                    divideFull(wideSum, d1, rem);
+                    d2 = gcdOf(rem, d1);
+                    wideSum = divideFull(wideSum, d2, rem);
+                }
+                if (!narrowChecked(wideSum, sum)) {
+                    return nullopt;
+                }
+            }
+        } else {
+            // Both products and their sum fit in wide_type, so only the reduced numerator can overflow.
+            wide_type left = static_cast<wide_type>(_frac._numerator) * (den / d1);
+            wide_type right = static_cast<wide_type>(num) * (_frac._denominator / d1);
+            wide_type wideSum = subtract ? left - right : left + right;
+            if (d1 != 1) {
+                d2 = gcdOf(static_cast<IntT>(wideSum % d1), d1);
+                wideSum /= d2;
+            }
+            if (!narrowChecked(wideSum, sum)) {
+                return nullopt;
+            }
+        }
+        // Coprime denominators (d1 == 1) leave the sum already reduced.
+        if (!mulChecked(IntT(_frac._denominator / d1), IntT(den / d2), resultDen)) {
+            return nullopt;
+        }
+        return fromParts(sum, resultDen);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::mulReduced(IntT n1, IntT d1, IntT n2,
+                                                                            IntT d2) noexcept {
+        IntT g1 = gcdOf(n1, d2);
+        IntT g2 = gcdOf(n2, d1);
+        IntT num = 0, den = 0;
+        if (!mulChecked(IntT(n1 / g1), IntT(n2 / g2), num) ||
+            !mulChecked(IntT(d1 / g2), IntT(d2 / g1), den)) {
+            return nullopt;
+        }
+        if (den < 0 && (!subChecked(IntT(0), num, num) || !subChecked(IntT(0), den, den))) {
+            return nullopt;
+        }
+        return fromParts(num, den);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::valueOrThrow(const optional<basic_fraction> &result) {
+        if (!result) {
+            throw overflow_error("OVERFLOW ERROR!\n");
+        }
+        return *result;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::resolve(const optional<basic_fraction> &result,
+                                                                const basic_fraction &_frac1,
+                                                                const basic_fraction &_frac2, char op) {
+        if (result) {
+            return *result;
+        }
+        if constexpr (!OverflowPolicy::needs_exact_result) {
+            OverflowPolicy::overflow();
+        } else {
+            using wide_type = typename fraction_traits<IntT>::wide_type;
+            static_assert(!is_void_v<wide_type>, "this overflow policy needs an integer type wider than IntT");
+            // Products of two IntT values and sums of two such products fit in wide_type.
+            wide_type n1 = _frac1._numerator, d1 = _frac1._denominator;
+            wide_type n2 = _frac2._numerator, d2 = _frac2._denominator;
+            wide_type num = op == '+' ? n1 * d2 + n2 * d1
+                          : op == '-' ? n1 * d2 - n2 * d1
+                          : op == '*' ? n1 * n2 : n1 * d2;
+            wide_type den = op == '/' ? d1 * n2 : d1 * d2;
+            if (den < 0) {
+                num = -num;
+                den = -den;
+            }
+            wide_type d = gcdOf(num, den);
+            IntT narrowNum = 0, narrowDen = 1;
+            OverflowPolicy::narrow(num / d, den / d, narrowNum, narrowDen);
+            basic_fraction value = fromParts(narrowNum, narrowDen);
+            value.normalize();
+            return value;
+        }
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::fromThousandths(double value) noexcept {
+        double scaled = floor(value);
+        // min is -2^digits, exactly representable; NaN fails both tests.
+        constexpr auto low = static_cast<double>(fraction_traits<IntT>::min);
+        if (!(scaled >= low && scaled < -low)) {
+            return nullopt;
+        }
+        auto num = static_cast<IntT>(scaled);
+        return overPowerOfTen(num < 0, magnitude(num), 3);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::overPowerOfTen(
+            bool negative, typename fraction_traits<IntT>::unsigned_type num, int digits) noexcept {
+        using unsigned_type = typename fraction_traits<IntT>::unsigned_type;
+        unsigned_type den = 1;
+        for (int i = 0; i < digits; ++i) {
+            den *= 10U;
+        }
+        if (num == 0) {
+            den = 1;
+        } else if constexpr (!ReducePolicy::lazy) {
+            // The gcd with 2^digits * 5^digits is a shift and a few divisions by 5.
+            int twos = trailingZeros(num) < digits ? trailingZeros(num) : digits;
+            num >>= twos;
+            den >>= twos;
+            for (int fives = 0; fives < digits && num % 5U == 0; ++fives) {
+                num /= 5U;
+                den /= 5U;
+            }
+        }
+        auto signedNum = static_cast<IntT>(negative ? static_cast<unsigned_type>(0U - num) : num);
+        return fromParts(signedNum, static_cast<IntT>(den));
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::checked_from(double dec) noexcept {
+        return fromThousandths(dec * 1000);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::checked_from(float flt) noexcept {
+        return fromThousandths(static_cast<double>(flt * 1000));
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    template<floating_point F>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::checked_from_exact(F x) noexcept {
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        bool negative = false;
+        if (!decomposeFloat(x, mantissa, exponent, negative)) {
+            return nullopt;
+        }
+        if (mantissa == 0) {
+            return basic_fraction();
+        }
+        int zeros = trailingZeros(mantissa);
+        mantissa >>= zeros;
+        exponent += zeros;
+        // An odd mantissa over a power of two is already reduced.
+        using carrier = unsigned __int128;
+        constexpr int digits = fraction_traits<IntT>::digits;
+        carrier limit = static_cast<carrier>(fraction_traits<IntT>::max) + (negative ? 1U : 0U);
+        carrier num = mantissa, den = 1;
+        if (exponent >= 0) {
+            if (bitWidth(mantissa) + exponent > digits + 1) {
+                return nullopt;
+            }
+            num <<= exponent;
+        } else {
+            if (-exponent >= digits) {
+                return nullopt;
+            }
+            den <<= -exponent;
+        }
+        if (num > limit) {
+            return nullopt;
+        }
+        using unsigned_type = typename fraction_traits<IntT>::unsigned_type;
+        auto magnitudeBits = static_cast<unsigned_type>(num);
+        auto signedNum = static_cast<IntT>(negative ? static_cast<unsigned_type>(0U - magnitudeBits) : magnitudeBits);
+        return fromParts(signedNum, static_cast<IntT>(den));
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    template<floating_point F>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::from_exact(F x) {
+        return valueOrThrow(checked_from_exact(x));
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    template<floating_point F>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::checked_round_to_digits(F x, int digits) noexcept {
+        using carrier = unsigned __int128;
+        constexpr int maxDigits = numeric_limits<uint64_t>::digits10;
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        bool negative = false;
+        if (digits < 0 || digits > maxDigits || !decomposeFloat(x, mantissa, exponent, negative)) {
+            return nullopt;
+        }
+        carrier scale = 1, fives = 1;
+        for (int i = 0; i < digits; ++i) {
+            scale *= 10U;
+            fives *= 5U;
+        }
+        if (scale > static_cast<carrier>(fraction_traits<IntT>::max)) {
+            return nullopt;
+        }
+        // x * 10^digits == mantissa * 5^digits * 2^shift; 2^53 * 5^19 < 2^99, so the product fits.
+        carrier scaled = mantissa * fives;
+        int shift = exponent + digits;
+        if (shift >= 0) {
+            if (scaled != 0 && bitWidth(scaled) + shift > fraction_traits<IntT>::digits + 1) {
+                return nullopt;
+            }
+            scaled <<= shift;
+        } else if (-shift >= 128) {
+            // scaled < 2^99, so the quotient rounds to 0.
+            scaled = 0;
+        } else {
+            carrier half = carrier(1) << (-shift - 1);
+            carrier rem = scaled & ((half << 1U) - 1);
+            scaled = (scaled >> -shift) + (rem >= half ? 1U : 0U);
+        }
+        carrier limit = static_cast<carrier>(fraction_traits<IntT>::max) + (negative ? 1U : 0U);
+        if (scaled > limit) {
+            return nullopt;
+        }
+        return overPowerOfTen(negative, static_cast<typename fraction_traits<IntT>::unsigned_type>(scaled), digits);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    template<floating_point F>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::round_to_digits(F x, int digits) {
+        return valueOrThrow(checked_round_to_digits(x, digits));
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::checked_from_double(double x, IntT max_den) noexcept {
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        bool negative = false;
+        if (max_den < 1 || !decomposeFloat(x, mantissa, exponent, negative)) {
+            return nullopt;
+        }
+        if (mantissa != 0) {
+            int zeros = trailingZeros(mantissa);
+            mantissa >>= zeros;
+            exponent += zeros;
+        }
+        if (mantissa == 0 || exponent >= 0) {
+            return checked_from_exact(x);
+        }
+        using carrier = unsigned __int128;
+        carrier num = mantissa, den = 0, limit = static_cast<carrier>(max_den);
+        if (-exponent > 127) {
+            // Round to a multiple of 2^-127; limit < 2^127, so the result is still approximated.
+            int drop = -exponent - 127;
+            num = drop >= 64 ? 0U : (mantissa >> drop) + ((mantissa >> (drop - 1)) & 1U);
+            den = carrier(1) << 127U;
+        } else {
+            den = carrier(1) << -exponent;
+        }
+        carrier p = num, q = den;
+        if (den <= limit) {
+            // x itself is the closest.
+        } else if (den <= numeric_limits<uint64_t>::max()) {
+            // 64-bit division is several times faster than the 128-bit library call.
+            uint64_t p64 = 0, q64 = 0;
+            bestApproximation(static_cast<uint64_t>(num), static_cast<uint64_t>(den), static_cast<uint64_t>(limit),
+                              p64, q64);
+            p = p64;
+            q = q64;
+        } else {
+            bestApproximation(num, den, limit, p, q);
+        }
+        if (p > static_cast<carrier>(fraction_traits<IntT>::max)) {
+            return nullopt;
+        }
+        auto signedNum = static_cast<IntT>(p);
+        return fromParts(negative ? static_cast<IntT>(-signedNum) : signedNum, static_cast<IntT>(q));
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::from_double(double x, IntT max_den) {
+        if (max_den < 1) {
+            throw invalid_argument("INVALID ERROR: Denominator bound must be positive!\n");
+        }
+        return valueOrThrow(checked_from_double(x, max_den));
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    void basic_fraction<IntT, ReducePolicy, OverflowPolicy>::from_double(span<const double> values,
+                                                                         span<basic_fraction> out, IntT max_den) {
+        if (out.size() < values.size()) {
+            throw invalid_argument("INVALID ERROR: Output span is shorter than the input!\n");
+        }
+        for (size_t i = 0; i < values.size(); ++i) {
+            out[i] = from_double(values[i], max_den);
+        }
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr basic_fraction<IntT, ReducePolicy, OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::limit_denominator(IntT max_den) const {
+        if (max_den < 1) {
+            throw invalid_argument("INVALID ERROR: Denominator bound must be positive!\n");
+        }
+        using unsigned_type = typename fraction_traits<IntT>::unsigned_type;
+        unsigned_type p = 0, q = 0;
+        bestApproximation(magnitude(this->_numerator), static_cast<unsigned_type>(this->_denominator),
+                          static_cast<unsigned_type>(max_den), p, q);
+        // p <= |numerator|, and only a min numerator can have p == max + 1, when nothing changed.
+        auto num = static_cast<IntT>(this->_numerator < 0 ? static_cast<unsigned_type>(0U - p) : p);
+        return fromParts(num, static_cast<IntT>(q));
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    constexpr strong_ordering
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::compareExpansions(IntT n1, IntT d1, IntT n2, IntT d2) {
+        while (true) {
+            // floor division, so both remainders are in [0, d); q * d itself may not fit
+            IntT r1 = n1 % d1, r2 = n2 % d2;
+            IntT q1 = n1 / d1 - (r1 < 0 ? 1 : 0);
+            IntT q2 = n2 / d2 - (r2 < 0 ? 1 : 0);
+            if (q1 != q2) {
+                return q1 <=> q2;
+            }
+            r1 += r1 < 0 ? d1 : IntT(0);
+            r2 += r2 < 0 ? d2 : IntT(0);
+            if (r1 == 0 || r2 == 0) {
+                return (r1 != 0) <=> (r2 != 0);
+            }
+            // r1/d1 < r2/d2 exactly when d2/r2 < d1/r1
+            n1 = d2;
+            n2 = d1;
+            d1 = r2;
+            d2 = r1;
+        }
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::operator double() const {
+        return to_double();
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::operator float() const {
+        return to_float();
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    double basic_fraction<IntT, ReducePolicy, OverflowPolicy>::to_double() const noexcept {
+        return quotient<double>(this->_numerator, this->_denominator);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    float basic_fraction<IntT, ReducePolicy, OverflowPolicy>::to_float() const noexcept {
+        return quotient<float>(this->_numerator, this->_denominator);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    double basic_fraction<IntT, ReducePolicy, OverflowPolicy>::to_rounded_double(int decimals) const {
+        // Powers of ten up to 10^22 are exact doubles.
+        constexpr double exactPowers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                          1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        double scale = decimals >= 0 && decimals <= 22 ? exactPowers[decimals] : pow(10.0, decimals);
+        return round(static_cast<double>(this->_numerator) * scale / static_cast<double>(this->_denominator)) / scale;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    void basic_fraction<IntT, ReducePolicy, OverflowPolicy>::to_double(span<const basic_fraction> values,
+                                                                       span<double> out) {
+        if (out.size() < values.size()) {
+            throw invalid_argument("INVALID ERROR: Output span is shorter than the input!\n");
+        }
+        if constexpr (fraction_traits<IntT>::digits <= numeric_limits<double>::digits) {
+            // Both parts are exact in a double, so this is a branch-free division loop (vectorized at -O3).
+            for (size_t i = 0; i < values.size(); ++i) {
+                out[i] = static_cast<double>(values[i]._numerator) / static_cast<double>(values[i]._denominator);
+            }
+        } else {
+            for (size_t i = 0; i < values.size(); ++i) {
+                out[i] = values[i].to_double();
+            }
+        }
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    void basic_fraction<IntT, ReducePolicy, OverflowPolicy>::to_float(span<const basic_fraction> values,
+                                                                      span<float> out) {
+        if (out.size() < values.size()) {
+            throw invalid_argument("INVALID ERROR: Output span is shorter than the input!\n");
+        }
+        for (size_t i = 0; i < values.size(); ++i) {
+            out[i] = values[i].to_float();
+        }
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    template<floating_point F>
+    F basic_fraction<IntT, ReducePolicy, OverflowPolicy>::quotient(IntT num, IntT den) noexcept {
+        using unsigned_type = typename fraction_traits<IntT>::unsigned_type;
+        constexpr int exactBits = numeric_limits<double>::digits;
+        bool exact = true;
+        if constexpr (fraction_traits<IntT>::digits > exactBits) {
+            constexpr auto limit = unsigned_type(1) << exactBits;
+            exact = magnitude(num) <= limit && static_cast<unsigned_type>(den) <= limit;
+        }
+        if (!exact) {
+            F value = quotientTo<F>(magnitude(num), static_cast<unsigned_type>(den));
+            return num < 0 ? -value : value;
+        }
+        double dividend = static_cast<double>(num), divisor = static_cast<double>(den);
+        double value = dividend / divisor;
+        if constexpr (is_same_v<F, double>) {
+            return value;
+        } else {
+            // value is correctly rounded, so it and num/den are on the same side of every float
+            // half way point except when value lands exactly on one; fma() then tells which side
+            // the exact quotient is on. |value| is in [2^-53, 2^53], where floats are normal.
+            auto result = static_cast<F>(value);
+            constexpr int lowBits = numeric_limits<double>::digits - numeric_limits<F>::digits;
+            auto bits = bit_cast<uint64_t>(value);
+            if ((bits & ((uint64_t(1) << lowBits) - 1)) == (uint64_t(1) << (lowBits - 1))) {
+                double error = fma(value, divisor, -dividend);
+                bool wantUp = error < 0;
+                if (error != 0 && wantUp != (static_cast<double>(result) > value)) {
+                    result = nextafter(result, wantUp ? numeric_limits<F>::infinity() : -numeric_limits<F>::infinity());
+                }
+            }
+            return result;
+        }
+    }
+
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    optional<basic_fraction<IntT, ReducePolicy, OverflowPolicy>>
+    basic_fraction<IntT, ReducePolicy, OverflowPolicy>::parse(string_view text, fraction_format format) noexcept {
+        basic_fraction value;
+        const char *end = text.data() + text.size();
+        from_chars_result result = from_chars(text.data(), end, value, format);
+        if (result.ec != errc{} || result.ptr != end) {
+            return nullopt;
+        }
+        return value;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    from_chars_result basic_fraction<IntT, ReducePolicy, OverflowPolicy>::decimalFromChars(
+            const char *first, const char *last, basic_fraction &value) noexcept {
+        using carrier = unsigned __int128;
+        const char *pos = first;
+        bool negative = pos != last && *pos == '-';
+        if (negative) {
+            ++pos;
+        }
+        // The digits before the repeating block, as num * 10^zeros.
+        carrier num = 0, repeat = 0;
+        int zeros = 0, repeatZeros = 0;
+        int intDigits = appendDigits(pos, last, num, zeros);
+        int fracDigits = 0, repeatDigits = 0;
+        if (pos != last && *pos == '.') {
+            ++pos;
+            fracDigits = appendDigits(pos, last, num, zeros);
+            if (pos != last && *pos == '(') {
+                const char *open = pos++;
+                repeatDigits = appendDigits(pos, last, repeat, repeatZeros);
+                if (repeatDigits != 0 && pos != last && *pos == ')') {
+                    ++pos;
+                } else {
+                    // Not a repeating block; the number ends before the parenthesis.
+                    pos = open;
+                    repeatDigits = 0;
+                }
+            }
+        }
+        if (intDigits == 0 && fracDigits == 0 && repeatDigits == 0) {
+            return {first, errc::invalid_argument};
+        }
+        int exponent = 0;
+        if (pos != last && (*pos == 'e' || *pos == 'E')) {
+            const char *mark = pos++;
+            bool negativeExponent = pos != last && *pos == '-';
+            if (pos != last && (*pos == '-' || *pos == '+')) {
+                ++pos;
+            }
+            const char *exponentDigits = pos;
+            for (; pos != last && static_cast<unsigned>(*pos - '0') < 10U; ++pos) {
+                // Beyond a million only 0 can be in range.
+                exponent = exponent < 1000000 ? exponent * 10 + (*pos - '0') : exponent;
+            }
+            if (pos == exponentDigits) {
+                pos = mark;
+            } else if (negativeExponent) {
+                exponent = -exponent;
+            }
+        }
+        if (intDigits < 0 || fracDigits < 0 || repeatDigits < 0) {
+            return {pos, errc::result_out_of_range};
+        }
+        // value = (num * 10^zeros + repeat / (10^repeatDigits - 1)) * 10^(exponent - fracDigits)
+        int scale = exponent - fracDigits;
+        carrier den = 1;
+        if (repeatDigits != 0) {
+            carrier nines = 1;
+            if (!mulPow10(nines, repeatDigits) || !mulPow10(num, zeros) || !mulPow10(repeat, repeatZeros) ||
+                __builtin_mul_overflow(num, nines - 1, &num) || __builtin_add_overflow(num, repeat, &num)) {
+                return {pos, errc::result_out_of_range};
+            }
+            den = nines - 1;
+            carrier d = binaryGcd(num, den);
+            num /= d;
+            den /= d;
+        } else {
+            scale += zeros;
+        }
+        if (num == 0) {
+            value = basic_fraction();
+            return {pos, errc{}};
+        }
+        if (scale > 0 && !mulPow10(num, scale)) {
+            return {pos, errc::result_out_of_range};
+        }
+        // den is 1 or coprime to 10, so cancelling 2s and 5s against 10^-scale leaves lowest terms.
+        if (scale < 0 && den == 1 && num >> 64U == 0 && -scale <= 19) {
+            // The common case, in 64-bit arithmetic: 128-bit division is a library call.
+            auto small = static_cast<uint64_t>(num);
+            uint64_t power = 1;
+            for (int i = 0; i < -scale; ++i) {
+                power *= 10U;
+            }
+            int twos = trailingZeros(small) < -scale ? trailingZeros(small) : -scale;
+            small >>= twos;
+            power >>= twos;
+            for (int fives = 0; fives < -scale && small % 5U == 0; ++fives) {
+                small /= 5U;
+                power /= 5U;
+            }
+            num = small;
+            den = power;
+        } else if (scale < 0) {
+            int twos = trailingZeros(num) < -scale ? trailingZeros(num) : -scale;
+            num >>= twos;
+            int fives = 0;
+            for (; fives < -scale && num % 5U == 0; ++fives) {
+                num /= 5U;
+            }
+            int denTwos = -scale - twos;
+            if (bitWidth(den) + denTwos > 128) {
+                return {pos, errc::result_out_of_range};
+            }
+            den <<= denTwos;
+            for (int i = fives; i < -scale; ++i) {
+                if (__builtin_mul_overflow(den, 5U, &den)) {
+                    return {pos, errc::result_out_of_range};
+                }
+            }
+        }
+        return fromMagnitudes(negative, num, den, pos, value);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    from_chars_result basic_fraction<IntT, ReducePolicy, OverflowPolicy>::mixedFromChars(
+            const char *first, const char *last, basic_fraction &value) noexcept {
+        using carrier = unsigned __int128;
+        auto readNumber = [last](const char *&pos, carrier &number) {
+            int zeros = 0;
+            int digits = appendDigits(pos, last, number, zeros);
+            return digits < 0 || !mulPow10(number, zeros) ? -1 : digits;
+        };
+        const char *pos = first;
+        bool negative = pos != last && *pos == '-';
+        if (negative) {
+            ++pos;
+        }
+        carrier whole = 0, num = 0, den = 1;
+        int digits = readNumber(pos, whole);
+        if (digits == 0) {
+            return {first, errc::invalid_argument};
+        }
+        const char *end = pos;
+        if (pos != last && *pos == '/') {
+            // "n/d" without a whole part.
+            den = 0;
+            digits = digits < 0 ? digits : readNumber(++pos, den);
+            if (digits == 0) {
+                return {first, errc::invalid_argument};
+            }
+            end = pos;
+            num = whole;
+            whole = 0;
+        } else {
+            while (pos != last && (*pos == ' ' || *pos == '\t')) {
+                ++pos;
+            }
+            carrier partNum = 0, partDen = 0;
+            const char *part = pos;
+            if (pos != end && readNumber(part, partNum) > 0 && part != last && *part == '/') {
+                int denDigits = readNumber(++part, partDen);
+                if (denDigits != 0) {
+                    digits = digits < 0 || denDigits < 0 ? -1 : digits;
+                    end = part;
+                    num = partNum;
+                    den = partDen;
+                }
+            }
+        }
+        if (digits < 0) {
+            return {end, errc::result_out_of_range};
+        }
+        if (den == 0) {
+            return {first, errc::argument_out_of_domain};
+        }
+        if (__builtin_mul_overflow(whole, den, &whole) || __builtin_add_overflow(whole, num, &num)) {
+            return {end, errc::result_out_of_range};
+        }
+        carrier d = binaryGcd(num, den);
+        return fromMagnitudes(negative, num / d, den / d, end, value);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    from_chars_result basic_fraction<IntT, ReducePolicy, OverflowPolicy>::fromMagnitudes(
+            bool negative, unsigned __int128 num, unsigned __int128 den, const char *end,
+            basic_fraction &value) noexcept {
+        using unsigned_type = typename fraction_traits<IntT>::unsigned_type;
+        constexpr auto max = static_cast<unsigned __int128>(fraction_traits<IntT>::max);
+        if (num > max + (negative ? 1U : 0U) || den > max) {
+            return {end, errc::result_out_of_range};
+        }
+        auto magnitudeNum = static_cast<unsigned_type>(num);
+        value = fromParts(static_cast<IntT>(negative ? static_cast<unsigned_type>(0U - magnitudeNum) : magnitudeNum),
+                          static_cast<IntT>(den));
+        return {end, errc{}};
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    from_chars_result from_chars(const char *first, const char *last,
+                                 basic_fraction<IntT, ReducePolicy, OverflowPolicy> &value) noexcept {
+        return from_chars(first, last, value, fraction_format::fraction);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    from_chars_result from_chars(const char *first, const char *last,
+                                 basic_fraction<IntT, ReducePolicy, OverflowPolicy> &value,
+                                 fraction_format format) noexcept {
+        using fraction_type = basic_fraction<IntT, ReducePolicy, OverflowPolicy>;
+        if (format == fraction_format::decimal) {
+            return fraction_type::decimalFromChars(first, last, value);
+        }
+        if (format == fraction_format::mixed) {
+            return fraction_type::mixedFromChars(first, last, value);
+        }
+        IntT num = 0, den = 1;
+        from_chars_result result = parseInt(first, last, num);
+        if (result.ec != errc{}) {
+            return result;
+        }
+        const char *pos = result.ptr;
+        if (pos != last && *pos == '/') {
+            result = parseInt(pos + 1, last, den);
+            if (result.ec == errc::invalid_argument) {
+                return {first, errc::invalid_argument};
+            }
+        } else {
+            while (pos != last && (*pos == ' ' || *pos == '\t')) {
+                ++pos;
+            }
+            if (pos != result.ptr) {
+                // A plain integer when no second number follows the blanks.
+                from_chars_result second = parseInt(pos, last, den);
+                if (second.ec != errc::invalid_argument) {
+                    result = second;
+                }
+            }
+        }
+        if (result.ec != errc{}) {
+            return result;
+        }
+        if (den == 0) {
+            return {first, errc::argument_out_of_domain};
+        }
+        optional<fraction_type> parsed = fraction_type::makeReduced(num, den);
+        if (!parsed) {
+            return {result.ptr, errc::result_out_of_range};
+        }
+        value = *parsed;
+        return result;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    to_chars_result to_chars(char *first, char *last, const basic_fraction<IntT, ReducePolicy, OverflowPolicy> &value,
+                             fraction_format format, int precision) noexcept {
+        using UIntT = typename fraction_traits<IntT>::unsigned_type;
+        basic_fraction<IntT, ReducePolicy, OverflowPolicy> lowest = value.reduced();
+        if (format == fraction_format::fraction) {
+            to_chars_result result = formatInt(first, last, lowest._numerator);
+            if (result.ec != errc{} || result.ptr == last) {
+                return {last, errc::value_too_large};
+            }
+            *result.ptr = '/';
+            return formatInt(result.ptr + 1, last, lowest._denominator);
+        }
+        if (format == fraction_format::decimal && precision < 0) {
+            return {first, errc::invalid_argument};
+        }
+        UIntT den = static_cast<UIntT>(lowest._denominator);
+        UIntT whole = magnitude(lowest._numerator) / den, rem = magnitude(lowest._numerator) % den;
+        char *pos = first;
+        if (lowest._numerator < 0) {
+            if (pos == last) {
+                return {last, errc::value_too_large};
+            }
+            *pos++ = '-';
+        }
+        char *digits = pos;
+        if (format == fraction_format::mixed) {
+            if (whole != 0 || rem == 0) {
+                to_chars_result result = formatInt(pos, last, whole);
+                if (result.ec != errc{} || (rem != 0 && result.ptr == last)) {
+                    return {last, errc::value_too_large};
+                }
+                pos = result.ptr;
+                if (rem == 0) {
+                    return {pos, errc{}};
+                }
+                *pos++ = ' ';
+            }
+            to_chars_result result = formatInt(pos, last, rem);
+            if (result.ec != errc{} || result.ptr == last) {
+                return {last, errc::value_too_large};
+            }
+            *result.ptr = '/';
+            return formatInt(result.ptr + 1, last, den);
+        }
+        to_chars_result result = formatInt(pos, last, whole);
+        if (result.ec != errc{} || (precision > 0 && last - result.ptr <= precision)) {
+            return {last, errc::value_too_large};
+        }
+        pos = result.ptr;
+        if (precision > 0) {
+            *pos++ = '.';
+        }
+        unsigned __int128 wideRem = rem;
+        pos = longDivision(wideRem, den, precision, pos);
+        rem = static_cast<UIntT>(wideRem);
+        bool lastOdd = (pos[-1] - '0') % 2 != 0;
+        if (rem > den - rem || (rem == den - rem && lastOdd)) {
+            char *carry = pos;
+            while (true) {
+                if (carry == digits) {
+                    // All nines: 9.99 becomes 10.00.
+                    if (pos == last) {
+                        return {last, errc::value_too_large};
+                    }
+                    for (char *move = pos; move != digits; --move) {
+                        *move = move[-1];
+                    }
+                    *digits = '1';
+                    ++pos;
+                    break;
+                }
+                --carry;
+                if (*carry == '9') {
+                    *carry = '0';
+                } else if (*carry != '.') {
+                    ++*carry;
+                    break;
+                }
+            }
+        }
+        return {pos, errc{}};
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    to_chars_result to_chars(char *first, char *last,
+                             const basic_fraction<IntT, ReducePolicy, OverflowPolicy> &value) noexcept {
+        return to_chars(first, last, value, fraction_format::fraction, 0);
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    string to_decimal(const basic_fraction<IntT, ReducePolicy, OverflowPolicy> &value, int digits, bool repeating) {
+        using carrier = unsigned __int128;
+        if (digits < 0) {
+            throw invalid_argument("INVALID ERROR: Number of digits can not be negative!\n");
+        }
+        basic_fraction<IntT, ReducePolicy, OverflowPolicy> lowest = value.reduced();
+        auto den = static_cast<carrier>(lowest._denominator);
+        // den = 2^twos * 5^fives * coprime; the repeating block starts after max(twos, fives) digits.
+        int twos = trailingZeros(den), fives = 0;
+        carrier coprime = den >> twos;
+        for (; coprime % 5U == 0; ++fives) {
+            coprime /= 5U;
+        }
+        int preperiod = twos > fives ? twos : fives, period = 0;
+        if (repeating && coprime != 1 && preperiod < digits) {
+            // Smallest k with 10^k == 1 (mod coprime); 10 * x is built from doublings so it never
+            // overflows, even for a 127-bit modulus.
+            auto addMod = [coprime](carrier a, carrier b) { return a >= coprime - b ? a - (coprime - b) : a + b; };
+            carrier power = 1;
+            for (int k = 1; k <= digits - preperiod; ++k) {
+                carrier twice = addMod(power, power);
+                power = addMod(addMod(twice, twice), power);
+                power = addMod(power, power);
+                if (power == 1) {
+                    period = k;
+                    break;
+                }
+            }
+        }
+        string text(static_cast<size_t>(digits) + 48, '\0');
+        if (period == 0) {
+            to_chars_result result = to_chars(text.data(), text.data() + text.size(), lowest, fraction_format::decimal,
+                                              digits);
+            text.resize(static_cast<size_t>(result.ptr - text.data()));
+            if (text.find('.') != string::npos) {
+                text.erase(text.find_last_not_of('0') + 1);
+                if (text.back() == '.') {
+                    text.pop_back();
+                }
+            }
+            return text == "-0" ? "0" : text;
+        }
+        char *pos = text.data();
+        if (lowest._numerator < 0) {
+            *pos++ = '-';
+        }
+        carrier rem = magnitude(lowest._numerator) % den;
+        pos = formatInt(pos, text.data() + text.size(), magnitude(lowest._numerator) / den).ptr;
+        *pos++ = '.';
+        pos = longDivision(rem, den, preperiod, pos);
+        *pos++ = '(';
+        pos = longDivision(rem, den, period, pos);
+        *pos++ = ')';
+        text.resize(static_cast<size_t>(pos - text.data()));
+        return text;
+    }
+
+    template<fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+    string to_decimal(const basic_fraction<IntT, ReducePolicy, OverflowPolicy> &value, int digits) {
+        return to_decimal(value, digits, false);
+    }
+
     /**
- * Check for overflow when adding 2 integers.
- * @param _n1
- * @param _n2
- * @return Sum of _n1 and _n2.
- * @throw overflow_error
- */
-    int addOvf(int _n1, int _n2);
+     * A std::format() spec for fractions: "" gives "n/d", "m" the mixed number and ".Nf" the decimal
+     * with N digits after the point ("f" means 6, like double). Kept apart from std::formatter so it
+     * builds, and is tested, on standard libraries without <format>.
+     */
+    struct fraction_format_spec {
+        static constexpr int max_precision = 256;
+        fraction_format style = fraction_format::fraction;
+        int precision = 6;
+
+        /**
+         * Reads the spec from [first, last), which ends at the closing '}' or at last.
+         * @return The position of the '}' (or last), or the offending position with
+         * errc::value_too_large for a precision above max_precision and errc::invalid_argument otherwise.
+         */
+        constexpr from_chars_result parse(const char *first, const char *last) noexcept {
+            const char *pos = first;
+            if (pos != last && *pos == '.') {
+                precision = 0;
+                for (++pos; pos != last && *pos >= '0' && *pos <= '9'; ++pos) {
+                    precision = precision * 10 + (*pos - '0');
+                    if (precision > max_precision) {
+                        return {pos, errc::value_too_large};
+                    }
+                }
+                if (pos == last || *pos != 'f') {
+                    return {pos, errc::invalid_argument};
+                }
+            }
+            if (pos != last && (*pos == 'f' || *pos == 'm')) {
+                style = *pos == 'f' ? fraction_format::decimal : fraction_format::mixed;
+                ++pos;
+            }
+            if (pos != last && *pos != '}') {
+                return {pos, errc::invalid_argument};
+            }
+            return {pos, errc{}};
+        }
+
+        /**
+         * Writes value to out in this spec through to_chars(), without allocating.
+         * @return The iterator past the last character written.
+         */
+        template<typename Out, fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+        Out format(Out out, const basic_fraction<IntT, ReducePolicy, OverflowPolicy> &value) const {
+            // Three integers with signs and separators, or a whole part, the point and the digits.
+            char text[3 * (fraction_traits<IntT>::digits / 3 + 3) + max_precision];
+            to_chars_result result = to_chars(text, text + sizeof(text), value, style, precision);
+            for (const char *pos = text; pos != result.ptr; ++pos) {
+                *out++ = *pos;
+            }
+            return out;
+        }
+    };
+
+    // Copies are plain memcpy: std::vector can relocate with memmove, and the type fits std::atomic.
+    static_assert(is_trivially_copyable_v<Fraction> && is_standard_layout_v<Fraction>);
+    static_assert(is_trivially_copyable_v<basic_fraction<int64_t>> && is_standard_layout_v<basic_fraction<int64_t>>);
+    static_assert(sizeof(Fraction) == 2 * sizeof(int));
 
     /**
-     * Check for overflow when multiplying 2 integers.
-     * @param _n1
-     * @param _n2
-     * @return Multiplication of _n1 and _n2.
-     * @throw overflow_error
+     * Fraction that defers the gcd on accumulation (see lazy_reduce).
      */
-    int mulOvf(int _n1, int _n2);
+    using LazyFraction = basic_fraction<int, lazy_reduce>;
+
+    extern template class basic_fraction<int32_t>;
+    extern template class basic_fraction<int64_t>;
+    extern template class basic_fraction<__int128>;
 
 }
-#endif
\ No newline at end of file
+
+#if __has_include(<format>)
+#include <format>
+#endif
+#ifdef __cpp_lib_format
+/**
+ * std::format() support through ariel::fraction_format_spec.
+ */
+template<ariel::fraction_integer IntT, typename ReducePolicy, typename OverflowPolicy>
+struct std::formatter<ariel::basic_fraction<IntT, ReducePolicy, OverflowPolicy>, char> {
+    ariel::fraction_format_spec spec;
+
+    constexpr auto parse(std::format_parse_context &context) {
+        const char *first = std::to_address(context.begin());
+        std::from_chars_result result = spec.parse(first, std::to_address(context.end()));
+        if (result.ec == std::errc::value_too_large) {
+            throw std::format_error("INVALID ERROR: Fraction precision is too large!");
+        }
+        if (result.ec != std::errc{}) {
+            throw std::format_error("INVALID ERROR: Unknown Fraction format!");
+        }
+        return context.begin() + (result.ptr - first);
+    }
+
+    template<typename FormatContext>
+    auto format(const ariel::basic_fraction<IntT, ReducePolicy, OverflowPolicy> &value, FormatContext &context) const {
+        return spec.format(context.out(), value);
+    }
+};
+#endif
+
+#endif
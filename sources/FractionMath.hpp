@@ -0,0 +1,628 @@
+#ifndef FRACTION_MATH_HPP
+#define FRACTION_MATH_HPP
+
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+namespace ariel {
+    /**
+     * Properties of an integer type usable as the numerator/denominator of a basic_fraction.
+     * Specialized for __int128, which the standard library does not know about in strict mode.
+     */
+    template<typename IntT>
+    struct fraction_traits {
+        static constexpr IntT max = std::numeric_limits<IntT>::max();
+        static constexpr IntT min = std::numeric_limits<IntT>::min();
+        static constexpr int digits = std::numeric_limits<IntT>::digits;
+        /** A type that holds the product of any two values, or void if there is none. */
+        using wide_type = std::conditional_t<(digits < 32), std::int64_t, __int128>;
+        using unsigned_type = std::make_unsigned_t<IntT>;
+    };
+
+    template<>
+    struct fraction_traits<__int128> {
+        static constexpr __int128 max = static_cast<__int128>(~static_cast<unsigned __int128>(0) >> 1U);
+        static constexpr __int128 min = -max - 1;
+        static constexpr int digits = 127;
+        using wide_type = void;
+        using unsigned_type = unsigned __int128;
+    };
+
+    /**
+     * Signed integer types basic_fraction can be instantiated with.
+     */
+    template<typename IntT>
+    concept fraction_integer = (std::is_integral_v<IntT> && std::is_signed_v<IntT>) || std::is_same_v<IntT, __int128>;
+
+    /**
+     * Integer types whose every value is also a value of IntT; the mixed fraction/integer
+     * operators take these directly instead of converting to a fraction first.
+     */
+    template<typename I, typename IntT>
+    concept narrower_integer = fraction_integer<I> && fraction_integer<IntT> &&
+                               fraction_traits<I>::digits <= fraction_traits<IntT>::digits;
+
+    constexpr int max_int = fraction_traits<int>::max;
+    constexpr int min_int = fraction_traits<int>::min;
+
+    /**
+     * Non-throwing checked addition.
+     * @param _n1
+     * @param _n2
+     * @param result Receives the sum when it fits.
+     * @return false on overflow.
+     */
+    template<fraction_integer IntT>
+    constexpr bool addChecked(IntT _n1, IntT _n2, IntT &result) noexcept {
+        return !__builtin_add_overflow(_n1, _n2, &result);
+    }
+
+    /**
+     * Non-throwing checked subtraction.
+     * @param _n1
+     * @param _n2
+     * @param result Receives _n1 minus _n2 when it fits.
+     * @return false on overflow.
+     */
+    template<fraction_integer IntT>
+    constexpr bool subChecked(IntT _n1, IntT _n2, IntT &result) noexcept {
+        return !__builtin_sub_overflow(_n1, _n2, &result);
+    }
+
+    /**
+     * Non-throwing checked multiplication.
+     * @param _n1
+     * @param _n2
+     * @param result Receives the product when it fits.
+     * @return false on overflow.
+     */
+    template<fraction_integer IntT>
+    constexpr bool mulChecked(IntT _n1, IntT _n2, IntT &result) noexcept {
+        return !__builtin_mul_overflow(_n1, _n2, &result);
+    }
+
+    /**
+     * Non-throwing checked narrowing from a wider integer type.
+     * @param value
+     * @param result Receives value when it fits in IntT.
+     * @return false when value is out of IntT's range.
+     */
+    template<fraction_integer IntT, fraction_integer WideT>
+    constexpr bool narrowChecked(WideT value, IntT &result) noexcept {
+        if (value < static_cast<WideT>(fraction_traits<IntT>::min) ||
+            value > static_cast<WideT>(fraction_traits<IntT>::max)) {
+            return false;
+        }
+        result = static_cast<IntT>(value);
+        return true;
+    }
+
+    /**
+     * Check for overflow when adding 2 integers.
+     * @param _n1
+     * @param _n2
+     * @return Sum of _n1 and _n2.
+     * @throw overflow_error
+     */
+    template<fraction_integer IntT>
+    constexpr IntT addOvf(IntT _n1, IntT _n2) {
+        IntT sum = 0;
+        if (!addChecked(_n1, _n2, sum)) {
+            throw std::overflow_error("OVERFLOW ERROR!\n");
+        }
+        return sum;
+    }
+
+    /**
+     * Check for overflow when subtracting 2 integers.
+     * @param _n1
+     * @param _n2
+     * @return _n1 minus _n2.
+     * @throw overflow_error
+     */
+    template<fraction_integer IntT>
+    constexpr IntT subOvf(IntT _n1, IntT _n2) {
+        IntT difference = 0;
+        if (!subChecked(_n1, _n2, difference)) {
+            throw std::overflow_error("OVERFLOW ERROR!\n");
+        }
+        return difference;
+    }
+
+    /**
+     * Check for overflow when multiplying 2 integers.
+     * @param _n1
+     * @param _n2
+     * @return Multiplication of _n1 and _n2.
+     * @throw overflow_error
+     */
+    template<fraction_integer IntT>
+    constexpr IntT mulOvf(IntT _n1, IntT _n2) {
+        IntT product = 0;
+        if (!mulChecked(_n1, _n2, product)) {
+            throw std::overflow_error("OVERFLOW ERROR!\n");
+        }
+        return product;
+    }
+
+    /**
+     * Check for overflow when negating an integer (only the minimum value overflows).
+     * @param _n
+     * @return -_n
+     * @throw overflow_error
+     */
+    template<fraction_integer IntT>
+    constexpr IntT negOvf(IntT _n) {
+        return subOvf(IntT(0), _n);
+    }
+
+    /**
+     * |_n| as the unsigned type of the same width, exact even for the minimum value.
+     */
+    template<fraction_integer IntT>
+    constexpr typename fraction_traits<IntT>::unsigned_type magnitude(IntT _n) noexcept {
+        using unsigned_type = typename fraction_traits<IntT>::unsigned_type;
+        auto bits = static_cast<unsigned_type>(_n);
+        return _n < 0 ? static_cast<unsigned_type>(unsigned_type(0) - bits) : bits;
+    }
+
+    /**
+     * Signed integer of twice the width of IntT as a sign and a two-half magnitude: the exact
+     * sums of products that addScaled() needs when IntT has no wider type (fraction_traits<IntT>::
+     * wide_type is void).
+     */
+    template<fraction_integer IntT>
+    struct double_width {
+        using half_type = typename fraction_traits<IntT>::unsigned_type;
+        bool negative = false;
+        half_type high = 0, low = 0;
+    };
+
+    /**
+     * The exact product _n1 * _n2.
+     */
+    template<fraction_integer IntT>
+    constexpr double_width<IntT> mulFull(IntT _n1, IntT _n2) noexcept {
+        using half_type = typename double_width<IntT>::half_type;
+        constexpr int quarter = static_cast<int>(sizeof(half_type)) * 4;
+        constexpr half_type mask = static_cast<half_type>((half_type(1) << quarter) - 1U);
+        half_type a = magnitude(_n1), b = magnitude(_n2);
+        half_type a0 = a & mask, a1 = a >> quarter, b0 = b & mask, b1 = b >> quarter;
+        half_type p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+        // At most 3 * (2^quarter - 1), so the middle column cannot overflow.
+        half_type middle = (p00 >> quarter) + (p01 & mask) + (p10 & mask);
+        double_width<IntT> result;
+        result.negative = (_n1 < 0) != (_n2 < 0) && a != 0 && b != 0;
+        result.low = (p00 & mask) | static_cast<half_type>(middle << quarter);
+        result.high = p11 + (p01 >> quarter) + (p10 >> quarter) + (middle >> quarter);
+        return result;
+    }
+
+    /**
+     * _n1 + _n2 for values below half the double-width range, such as two products of IntT values.
+     */
+    template<fraction_integer IntT>
+    constexpr double_width<IntT> addFull(const double_width<IntT> &_n1, const double_width<IntT> &_n2) noexcept {
+        using half_type = typename double_width<IntT>::half_type;
+        double_width<IntT> result;
+        if (_n1.negative == _n2.negative) {
+            result.low = _n1.low + _n2.low;
+            result.high = _n1.high + _n2.high + (result.low < _n1.low ? 1U : 0U);
+            result.negative = _n1.negative;
+            return result;
+        }
+        bool firstLarger = _n1.high != _n2.high ? _n1.high > _n2.high : _n1.low >= _n2.low;
+        const double_width<IntT> &larger = firstLarger ? _n1 : _n2, &smaller = firstLarger ? _n2 : _n1;
+        result.low = larger.low - smaller.low;
+        result.high = larger.high - smaller.high - (larger.low < smaller.low ? half_type(1) : half_type(0));
+        result.negative = larger.negative && (result.high | result.low) != 0;
+        return result;
+    }
+
+    /**
+     * value / den truncated toward zero, by binary long division.
+     * @param den Must be positive.
+     * @param rem Receives |value| % den.
+     */
+    template<fraction_integer IntT>
+    constexpr double_width<IntT> divideFull(const double_width<IntT> &value, IntT den, IntT &rem) noexcept {
+        using half_type = typename double_width<IntT>::half_type;
+        constexpr int bits = static_cast<int>(sizeof(half_type)) * 8;
+        auto divisor = static_cast<half_type>(den);
+        half_type r = 0;
+        double_width<IntT> quotient;
+        for (int i = 2 * bits - 1; i >= 0; --i) {
+            // r < den <= max, so doubling it cannot overflow.
+            half_type bit = i >= bits ? value.high >> (i - bits) : value.low >> i;
+            r = static_cast<half_type>(r << 1U) | (bit & 1U);
+            if (r >= divisor) {
+                r -= divisor;
+                (i >= bits ? quotient.high : quotient.low) |= static_cast<half_type>(half_type(1) << (i % bits));
+            }
+        }
+        quotient.negative = value.negative && (quotient.high | quotient.low) != 0;
+        rem = static_cast<IntT>(r);
+        return quotient;
+    }
+
+    /**
+     * Non-throwing narrowing of a double_width value to IntT.
+     * @return false when it is out of IntT's range.
+     */
+    template<fraction_integer IntT>
+    constexpr bool narrowChecked(const double_width<IntT> &value, IntT &result) noexcept {
+        using half_type = typename double_width<IntT>::half_type;
+        auto limit = static_cast<half_type>(static_cast<half_type>(fraction_traits<IntT>::max) + (value.negative ? 1U : 0U));
+        if (value.high != 0 || value.low > limit) {
+            return false;
+        }
+        result = static_cast<IntT>(value.negative ? static_cast<half_type>(half_type(0) - value.low) : value.low);
+        return true;
+    }
+
+    /**
+     * Number of trailing zero bits of a non-zero unsigned value.
+     */
+    template<typename UIntT>
+    constexpr int trailingZeros(UIntT _n) noexcept {
+        if constexpr (sizeof(UIntT) <= sizeof(unsigned)) {
+            return __builtin_ctz(_n);
+        } else if constexpr (sizeof(UIntT) <= sizeof(unsigned long long)) {
+            return __builtin_ctzll(_n);
+        } else {
+            auto low = static_cast<unsigned long long>(_n);
+            return low != 0 ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<unsigned long long>(_n >> 64U));
+        }
+    }
+
+    /**
+     * Number of significant bits of an unsigned value (0 for 0).
+     */
+    template<typename UIntT>
+    constexpr int bitWidth(UIntT _n) noexcept {
+        int width = 0;
+        if constexpr (sizeof(UIntT) > sizeof(unsigned long long)) {
+            if ((_n >> 64U) != 0) {
+                width = 64;
+                _n >>= 64U;
+            }
+        }
+        auto word = static_cast<unsigned long long>(_n);
+        return word == 0 ? width : width + 64 - __builtin_clzll(word);
+    }
+
+    /**
+     * Splits a finite IEEE-754 float or double into (-1)^negative * mantissa * 2^exponent with an
+     * integer mantissa, read straight from its bits (no frexp, no floating point operations).
+     * The mantissa is 0 for +-0.
+     * @return false for infinities and NaN.
+     */
+    template<std::floating_point F>
+    constexpr bool decomposeFloat(F x, std::uint64_t &mantissa, int &exponent, bool &negative) noexcept {
+        static_assert(std::numeric_limits<F>::is_iec559 && (sizeof(F) == 4 || sizeof(F) == 8),
+                      "only IEEE-754 binary32 and binary64 are supported");
+        using bits_type = std::conditional_t<sizeof(F) == 8, std::uint64_t, std::uint32_t>;
+        constexpr int fractionBits = std::numeric_limits<F>::digits - 1;
+        constexpr int exponentBits = static_cast<int>(sizeof(F) * 8) - 1 - fractionBits;
+        constexpr int bias = (1 << (exponentBits - 1)) - 1;
+        auto bits = std::bit_cast<bits_type>(x);
+        negative = (bits >> (sizeof(F) * 8 - 1)) != 0;
+        auto biased = static_cast<int>((bits >> fractionBits) & ((1U << exponentBits) - 1));
+        std::uint64_t fraction = bits & ((bits_type(1) << fractionBits) - 1);
+        if (biased == (1 << exponentBits) - 1) {
+            return false;
+        }
+        if (biased == 0) {
+            // Subnormal: no implicit leading bit.
+            mantissa = fraction;
+            exponent = 1 - bias - fractionBits;
+        } else {
+            mantissa = fraction | (std::uint64_t(1) << fractionBits);
+            exponent = biased - bias - fractionBits;
+        }
+        return true;
+    }
+
+    /**
+     * _n1 / _n2 correctly rounded to F (round to nearest, ties to even), by long division on the
+     * integers: enough quotient bits for the precision plus a guard bit, then a sticky bit from
+     * the remainder. Handles results in F's subnormal range.
+     * @param _n2 Must be positive.
+     */
+    template<std::floating_point F, typename UIntT>
+    F quotientTo(UIntT _n1, UIntT _n2) noexcept {
+        // Twice the input width lets one division produce all the missing quotient bits.
+        using carrier = std::conditional_t<(sizeof(UIntT) <= 8), unsigned __int128, UIntT>;
+        constexpr int width = static_cast<int>(sizeof(carrier) * 8);
+        constexpr int precision = std::numeric_limits<F>::digits;
+        if (_n1 == 0) {
+            return F(0);
+        }
+        carrier mantissa = carrier(_n1) / _n2, rem = carrier(_n1) % _n2;
+        int exponent = 0;
+        // Quotient bits are produced in chunks small enough that neither the shifted remainder
+        // (rem < _n2) nor the mantissa (below 2^(precision + 2) once nonzero) overflows.
+        while (bitWidth(mantissa) < precision + 2 && rem != 0) {
+            int chunk = width - bitWidth(rem);
+            int needed = mantissa == 0 ? width : precision + 2 - bitWidth(mantissa);
+            chunk = chunk < needed ? chunk : needed;
+            rem <<= chunk;
+            mantissa = (mantissa << chunk) | (rem / _n2);
+            rem %= _n2;
+            exponent -= chunk;
+        }
+        int top = exponent + bitWidth(mantissa) - 1;
+        int keep = precision;
+        if (top < std::numeric_limits<F>::min_exponent - 1) {
+            keep -= std::numeric_limits<F>::min_exponent - 1 - top;
+        }
+        int extra = bitWidth(mantissa) - (keep > 0 ? keep : 0);
+        if (extra > 0) {
+            carrier low = mantissa & ((carrier(1) << extra) - 1);
+            carrier half = carrier(1) << (extra - 1);
+            mantissa >>= extra;
+            exponent += extra;
+            if (low > half || (low == half && (rem != 0 || (mantissa & 1U) != 0))) {
+                ++mantissa;
+            }
+        }
+        return std::ldexp(static_cast<F>(mantissa), exponent);
+    }
+
+    /**
+     * Binary (Stein) gcd: shifts and subtractions only, with the swap done by min/max
+     * so the loop body has no data-dependent branch.
+     */
+    template<typename UIntT>
+    constexpr UIntT binaryGcd(UIntT _n1, UIntT _n2) noexcept {
+        if (_n1 == 0 || _n2 == 0) {
+            return _n1 | _n2;
+        }
+        int shift = trailingZeros(UIntT(_n1 | _n2));
+        _n1 >>= trailingZeros(_n1);
+        do {
+            _n2 >>= trailingZeros(_n2);
+            UIntT low = _n1 < _n2 ? _n1 : _n2;
+            UIntT high = _n1 < _n2 ? _n2 : _n1;
+            _n1 = low;
+            _n2 = high - low;
+        } while (_n2 != 0);
+        return _n1 << shift;
+    }
+
+    /**
+     * Best rational approximation p/q of num/den with q <= maxDen (Python's
+     * Fraction.limit_denominator): walks the continued fraction of num/den and picks the closer
+     * of the last convergent and the last semiconvergent that fit. Never overflows, since every
+     * candidate has p <= num and q <= den.
+     * @param den Must be positive; num/den need not be reduced.
+     * @param maxDen Must be positive.
+     */
+    template<typename UIntT>
+    constexpr void bestApproximation(UIntT num, UIntT den, UIntT maxDen, UIntT &p, UIntT &q) noexcept {
+        if (den <= maxDen) {
+            p = num;
+            q = den;
+            return;
+        }
+        UIntT p0 = 0, q0 = 1, p1 = 1, q1 = 0, n = num, d = den;
+        while (d != 0) {
+            UIntT a = n / d;
+            if (q1 != 0 && a > (maxDen - q0) / q1) {
+                break;
+            }
+            UIntT p2 = p0 + a * p1, q2 = q0 + a * q1;
+            p0 = p1;
+            q0 = q1;
+            p1 = p2;
+            q1 = q2;
+            UIntT rem = n - a * d;
+            n = d;
+            d = rem;
+        }
+        if (d == 0) {
+            // num/den was not reduced, and its reduced form fits.
+            p = p1;
+            q = q1;
+            return;
+        }
+        UIntT k = (maxDen - q0) / q1;
+        UIntT semiDen = q0 + k * q1;
+        // The convergent p1/q1 is at least as close exactly when 2 * d * semiDen <= den.
+        if (d <= den / 2 / semiDen) {
+            p = p1;
+            q = q1;
+        } else {
+            p = p0 + k * p1;
+            q = semiDen;
+        }
+    }
+
+    /**
+     * std::from_chars() for a base-10 IntT with an optional '-' sign; the standard one has no
+     * overload for __int128.
+     * @return errc::invalid_argument (and ptr == first) when there are no digits,
+     * errc::result_out_of_range when the value does not fit. value is only written on success.
+     */
+    template<fraction_integer IntT>
+    std::from_chars_result parseInt(const char *first, const char *last, IntT &value) noexcept {
+        if constexpr (std::is_integral_v<IntT>) {
+            return std::from_chars(first, last, value);
+        } else {
+            using UIntT = typename fraction_traits<IntT>::unsigned_type;
+            const char *pos = first;
+            bool negative = pos != last && *pos == '-';
+            if (negative) {
+                ++pos;
+            }
+            const char *digits = pos;
+            UIntT limit = static_cast<UIntT>(fraction_traits<IntT>::max) + (negative ? 1U : 0U);
+            UIntT result = 0;
+            bool fits = true;
+            for (; pos != last && static_cast<unsigned>(*pos - '0') < 10U; ++pos) {
+                auto digit = static_cast<UIntT>(*pos - '0');
+                if (fits && result <= (limit - digit) / 10U) {
+                    result = result * 10U + digit;
+                } else {
+                    fits = false;
+                }
+            }
+            if (pos == digits) {
+                return {first, std::errc::invalid_argument};
+            }
+            if (!fits) {
+                return {pos, std::errc::result_out_of_range};
+            }
+            value = static_cast<IntT>(negative ? UIntT(0) - result : result);
+            return {pos, std::errc{}};
+        }
+    }
+
+    /**
+     * value * 10^times, or false when that does not fit.
+     */
+    constexpr bool mulPow10(unsigned __int128 &value, int times) noexcept {
+        for (; times > 0 && value != 0; --times) {
+            if (__builtin_mul_overflow(value, 10U, &value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Reads the decimal digits at pos, moving pos past them, so that value * 10^zeros is the number
+     * read. Once value is large, zeros are only counted; that keeps "1.5000...0" and "1500...0e-40"
+     * from overflowing. Counts stop growing at 2^20 (the result is out of range anyway).
+     * @return The number of digits read, or -1 when value overflowed.
+     */
+    constexpr int appendDigits(const char *&pos, const char *last, unsigned __int128 &value, int &zeros) noexcept {
+        constexpr int maxCount = 1 << 20;
+        int count = 0;
+        bool fits = true;
+        for (; pos != last && static_cast<unsigned>(*pos - '0') < 10U; ++pos) {
+            auto digit = static_cast<unsigned>(*pos - '0');
+            count += count < maxCount ? 1 : 0;
+            if (zeros == 0 && value >> 59U == 0) {
+                // Most digits: no overflow possible, and 64-bit arithmetic is enough.
+                value = static_cast<std::uint64_t>(value) * 10U + digit;
+            } else if (digit == 0) {
+                zeros += zeros < maxCount ? 1 : 0;
+            } else {
+                fits = fits && mulPow10(value, zeros + 1) && !__builtin_add_overflow(value, digit, &value);
+                zeros = 0;
+            }
+        }
+        return fits && count < maxCount ? count : -1;
+    }
+
+    /**
+     * Writes the next count decimal digits of rem / den (rem < den) to out and leaves the remainder
+     * in rem. Takes up to 18 digits per division, as many as keep rem * 10^k below 2^128: for a
+     * den of 64 bits or less that is one 128-by-64-bit divide per 18 digits.
+     * @return out + count.
+     */
+    constexpr char *longDivision(unsigned __int128 &rem, unsigned __int128 den, int count, char *out) noexcept {
+        // 10^chunk <= 2^(128 - bitWidth(den)); log10(2) ~ 0.30103.
+        int chunk = (128 - bitWidth(den)) * 30103 / 100000;
+        chunk = chunk < 18 ? chunk : 18;
+        if (chunk == 0) {
+            // den > 2^125: 10 * rem may not fit, so add rem ten times modulo den.
+            for (; count > 0; --count) {
+                unsigned digit = 0;
+                unsigned __int128 sum = 0;
+                for (int k = 0; k < 10; ++k) {
+                    sum += rem;
+                    if (sum >= den || sum < rem) {
+                        sum -= den;
+                        ++digit;
+                    }
+                }
+                rem = sum;
+                *out++ = static_cast<char>('0' + digit);
+            }
+            return out;
+        }
+        while (count > 0) {
+            int step = count < chunk ? count : chunk;
+            std::uint64_t scale = 1;
+            for (int i = 0; i < step; ++i) {
+                scale *= 10U;
+            }
+            rem *= scale;
+            auto quotient = static_cast<std::uint64_t>(rem / den);
+            rem -= quotient * den;
+            for (int i = step - 1; i >= 0; --i) {
+                out[i] = static_cast<char>('0' + quotient % 10U);
+                quotient /= 10U;
+            }
+            out += step;
+            count -= step;
+        }
+        return out;
+    }
+
+    /**
+     * std::to_chars() in base 10 that also takes __int128 and unsigned __int128.
+     * @return errc::value_too_large (and ptr == last) when [first, last) is too short.
+     */
+    template<typename IntT>
+    std::to_chars_result formatInt(char *first, char *last, IntT value) noexcept {
+        if constexpr (std::is_integral_v<IntT>) {
+            return std::to_chars(first, last, value);
+        } else {
+            char digits[40];
+            char *pos = digits + sizeof(digits);
+            bool negative = false;
+            if constexpr (std::is_same_v<IntT, __int128>) {
+                negative = value < 0;
+            }
+            do {
+                int digit = static_cast<int>(value % 10);
+                *--pos = static_cast<char>('0' + (negative ? -digit : digit));
+                value /= 10;
+            } while (value != 0);
+            if (last - first < digits + sizeof(digits) - pos + (negative ? 1 : 0)) {
+                return {last, std::errc::value_too_large};
+            }
+            if (negative) {
+                *first++ = '-';
+            }
+            for (; pos != digits + sizeof(digits); ++pos) {
+                *first++ = *pos;
+            }
+            return {first, std::errc{}};
+        }
+    }
+
+#ifdef FRACTION_COUNT_GCD
+    /** Number of gcdOf() calls made at run time; only kept in instrumented builds (`make bench`). */
+    inline unsigned long long gcdCalls = 0;
+#endif
+
+    /**
+     * Greatest common divisor of |_n1| and |_n2| (0 when both are 0).
+     * Works on the unsigned magnitudes, so the minimum value is handled.
+     * binaryGcd() beats both Euclid and Lehmer's algorithm at every width on x86-64 (see `make bench`),
+     * including __int128, where it avoids the library calls behind 128-bit division.
+     */
+    template<fraction_integer IntT>
+    constexpr IntT gcdOf(IntT _n1, IntT _n2) {
+#ifdef FRACTION_COUNT_GCD
+        if (!std::is_constant_evaluated()) {
+            ++gcdCalls;
+        }
+#endif
+        return static_cast<IntT>(binaryGcd(magnitude(_n1), magnitude(_n2)));
+    }
+
+}
+#endif
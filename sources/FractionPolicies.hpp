@@ -0,0 +1,105 @@
+#ifndef FRACTION_POLICIES_HPP
+#define FRACTION_POLICIES_HPP
+
+#include <stdexcept>
+#include "FractionMath.hpp"
+
+namespace ariel {
+    /**
+     * Reduction policy: every operation leaves the result in lowest terms (the default).
+     */
+    struct eager_reduce {
+        static constexpr bool lazy = false;
+    };
+
+    /**
+     * Reduction policy: results are kept unreduced (sign normalized only) and the gcd is skipped
+     * until the numerator or denominator grows wider than 3/4 of the bits of the integer type.
+     * If an operation would still overflow, the operands are reduced and it is retried.
+     * Suits accumulation loops and short expressions, where most gcds are wasted work.
+     * Observers (getNumerator(), getDenominator(), <<, ==) see the reduced value.
+     */
+    struct lazy_reduce {
+        static constexpr bool lazy = true;
+    };
+
+    /**
+     * Overflow policy: an operation whose result does not fit throws overflow_error (the default).
+     */
+    struct throw_on_overflow {
+        static constexpr bool needs_exact_result = false;
+
+        [[noreturn]] static void overflow() {
+            throw std::overflow_error("OVERFLOW ERROR!\n");
+        }
+    };
+
+    /**
+     * Overflow policy: a result that does not fit is replaced by the nearest representable value,
+     * max/1 (or -max/1) past the range, otherwise a best rational approximation whose numerator
+     * and denominator fit.
+     * Works from the exact result in the wider type, so it is not available for __int128.
+     */
+    struct saturate_on_overflow {
+        static constexpr bool needs_exact_result = true;
+
+        /**
+         * @param num, den The exact reduced result, den > 0.
+         */
+        template<fraction_integer IntT, fraction_integer WideT>
+        static constexpr void narrow(WideT num, WideT den, IntT &outNum, IntT &outDen) noexcept {
+            using unsigned_type = typename fraction_traits<WideT>::unsigned_type;
+            constexpr auto limit = static_cast<unsigned_type>(fraction_traits<IntT>::max);
+            unsigned_type absNum = magnitude(num), absDen = magnitude(den), p = limit, q = 1;
+            unsigned_type whole = absNum / absDen;
+            if (whole < limit || (whole == limit && absNum % absDen == 0)) {
+                if (absNum <= absDen) {
+                    bestApproximation(absNum, absDen, limit, p, q);
+                } else {
+                    // Bounding the numerator of x is bounding the denominator of 1/x.
+                    bestApproximation(absDen, absNum, limit, q, p);
+                }
+            }
+            outNum = num < 0 ? static_cast<IntT>(-static_cast<IntT>(p)) : static_cast<IntT>(p);
+            outDen = static_cast<IntT>(q);
+        }
+    };
+
+    /**
+     * Overflow policy: a result that does not fit keeps the low bits of the magnitudes of its
+     * reduced numerator and denominator (a denominator that wraps to 0 becomes 1) and raises a
+     * sticky per-thread flag, so a batch of operations is checked once at the end.
+     * Works from the exact result in the wider type, so it is not available for __int128.
+     */
+    struct wrap_on_overflow {
+        static constexpr bool needs_exact_result = true;
+
+        /**
+         * True when an operation on this thread has wrapped since the last clear().
+         */
+        static bool overflowed() noexcept { return flag; }
+
+        static void clear() noexcept { flag = false; }
+
+        /**
+         * @param num, den The exact reduced result, den > 0.
+         */
+        template<fraction_integer IntT, fraction_integer WideT>
+        static void narrow(WideT num, WideT den, IntT &outNum, IntT &outDen) noexcept {
+            using unsigned_type = typename fraction_traits<WideT>::unsigned_type;
+            constexpr auto mask = static_cast<unsigned_type>(fraction_traits<IntT>::max);
+            auto low = static_cast<IntT>(magnitude(num) & mask);
+            outNum = num < 0 ? static_cast<IntT>(-low) : low;
+            outDen = static_cast<IntT>(magnitude(den) & mask);
+            if (outDen == 0) {
+                outDen = 1;
+            }
+            flag = true;
+        }
+
+    private:
+        static inline thread_local bool flag = false;
+    };
+
+}
+#endif
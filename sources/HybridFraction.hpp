@@ -0,0 +1,263 @@
+#ifndef HYBRID_FRACTION_HPP
+#define HYBRID_FRACTION_HPP
+
+#include <compare>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include "BigFraction.hpp"
+#include "Fraction.hpp"
+
+using namespace std;
+namespace ariel {
+    /**
+     * Fraction that never overflows. A value whose reduced numerator and denominator fit in IntT
+     * is stored inline as a basic_fraction<IntT> and computed with its checked fast paths; an
+     * operation that would overflow is redone in BigFraction, and only a result that still does
+     * not fit stays on the heap. So a value is big exactly when it does not fit, and == compares
+     * the representations.
+     * Only division by 0 and a 0 denominator throw, as they do for basic_fraction.
+     */
+    template<fraction_integer IntT>
+    class basic_hybrid_fraction {
+    public:
+        using small_type = basic_fraction<IntT>;
+
+    private:
+        small_type _small;
+        unique_ptr<BigFraction> _big;
+
+    public:
+        basic_hybrid_fraction() = default;
+
+        /**
+         * @throw invalid_argument when denominator is 0.
+         */
+        basic_hybrid_fraction(IntT numerator, IntT denominator) {
+            if (numerator == fraction_traits<IntT>::min || denominator == fraction_traits<IntT>::min) {
+                // Moving the sign may not fit; let BigFraction reduce it.
+                *this = basic_hybrid_fraction(BigFraction(numerator, denominator));
+            } else {
+                _small = small_type(numerator, denominator);
+            }
+        }
+
+        /** Whole number n/1, big when n does not fit in IntT. */
+        template<fraction_integer I>
+        basic_hybrid_fraction(I n) {
+            if constexpr (fraction_traits<I>::digits > fraction_traits<IntT>::digits) {
+                if (n > static_cast<I>(fraction_traits<IntT>::max) || n < static_cast<I>(fraction_traits<IntT>::min)) {
+                    _big = make_unique<BigFraction>(n);
+                    return;
+                }
+            }
+            _small = small_type(static_cast<IntT>(n));
+        }
+
+        basic_hybrid_fraction(const small_type &_frac) noexcept : _small(_frac) {}
+
+        /** Demotes _frac when it fits in IntT. */
+        basic_hybrid_fraction(BigFraction _frac) {
+            if (optional<small_type> value = _frac.checked_to_fraction<small_type>()) {
+                _small = *value;
+            } else {
+                _big = make_unique<BigFraction>(std::move(_frac));
+            }
+        }
+
+        basic_hybrid_fraction(const basic_hybrid_fraction &_frac)
+                : _small(_frac._small), _big(_frac._big ? make_unique<BigFraction>(*_frac._big) : nullptr) {}
+
+        basic_hybrid_fraction(basic_hybrid_fraction &&_frac) noexcept = default;
+
+        basic_hybrid_fraction &operator=(const basic_hybrid_fraction &_frac) {
+            if (this != &_frac) {
+                _small = _frac._small;
+                _big = _frac._big ? make_unique<BigFraction>(*_frac._big) : nullptr;
+            }
+            return *this;
+        }
+
+        basic_hybrid_fraction &operator=(basic_hybrid_fraction &&_frac) noexcept = default;
+
+        /** True when the value is stored inline. */
+        bool is_small() const noexcept { return !_big; }
+
+        /**
+         * The inline value.
+         * @throw overflow_error when the value does not fit in IntT.
+         */
+        const small_type &to_fraction() const {
+            if (_big) {
+                throw overflow_error("OVERFLOW ERROR!\n");
+            }
+            return _small;
+        }
+
+        /** The value as a BigFraction, whichever way it is stored. */
+        BigFraction to_big() const {
+            return _big ? *_big : BigFraction(_small);
+        }
+
+        BigInt getNumerator() const {
+            return _big ? _big->getNumerator() : BigInt(_small.getNumerator());
+        }
+
+        BigInt getDenominator() const {
+            return _big ? _big->getDenominator() : BigInt(_small.getDenominator());
+        }
+
+        // Arithmetic operations:
+        friend basic_hybrid_fraction operator+(const basic_hybrid_fraction &_frac1,
+                                               const basic_hybrid_fraction &_frac2) {
+            if (!_frac1._big && !_frac2._big) {
+                if (optional<small_type> result = checked_add(_frac1._small, _frac2._small)) {
+                    return *result;
+                }
+            }
+            return promoted(_frac1, _frac2, '+');
+        }
+
+        friend basic_hybrid_fraction operator-(const basic_hybrid_fraction &_frac1,
+                                               const basic_hybrid_fraction &_frac2) {
+            if (!_frac1._big && !_frac2._big) {
+                if (optional<small_type> result = checked_sub(_frac1._small, _frac2._small)) {
+                    return *result;
+                }
+            }
+            return promoted(_frac1, _frac2, '-');
+        }
+
+        friend basic_hybrid_fraction operator*(const basic_hybrid_fraction &_frac1,
+                                               const basic_hybrid_fraction &_frac2) {
+            if (!_frac1._big && !_frac2._big) {
+                if (optional<small_type> result = checked_mul(_frac1._small, _frac2._small)) {
+                    return *result;
+                }
+            }
+            return promoted(_frac1, _frac2, '*');
+        }
+
+        /**
+         * @throw overflow_error when _frac2 is 0.
+         */
+        friend basic_hybrid_fraction operator/(const basic_hybrid_fraction &_frac1,
+                                               const basic_hybrid_fraction &_frac2) {
+            if (!_frac1._big && !_frac2._big) {
+                if (optional<small_type> result = checked_div(_frac1._small, _frac2._small)) {
+                    return *result;
+                }
+                if (_frac2._small.getNumerator() == 0) {
+                    throw overflow_error("ARITHMETIC ERROR: Can not divide by 0!");
+                }
+            }
+            return promoted(_frac1, _frac2, '/');
+        }
+
+        basic_hybrid_fraction operator-() const {
+            if (!_big && _small.getNumerator() != fraction_traits<IntT>::min) {
+                return -_small;
+            }
+            return -to_big();
+        }
+
+        basic_hybrid_fraction &operator+=(const basic_hybrid_fraction &_frac) {
+            return *this = *this + _frac;
+        }
+
+        basic_hybrid_fraction &operator-=(const basic_hybrid_fraction &_frac) {
+            return *this = *this - _frac;
+        }
+
+        basic_hybrid_fraction &operator*=(const basic_hybrid_fraction &_frac) {
+            return *this = *this * _frac;
+        }
+
+        basic_hybrid_fraction &operator/=(const basic_hybrid_fraction &_frac) {
+            return *this = *this / _frac;
+        }
+
+        basic_hybrid_fraction &operator++() {
+            return *this += 1;
+        }
+
+        basic_hybrid_fraction operator++(int) {
+            basic_hybrid_fraction copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        basic_hybrid_fraction &operator--() {
+            return *this -= 1;
+        }
+
+        basic_hybrid_fraction operator--(int) {
+            basic_hybrid_fraction copy = *this;
+            --*this;
+            return copy;
+        }
+
+        // Comparison operations:
+        friend bool operator==(const basic_hybrid_fraction &_frac1, const basic_hybrid_fraction &_frac2) {
+            if (!_frac1._big && !_frac2._big) {
+                return _frac1._small == _frac2._small;
+            }
+            return _frac1._big && _frac2._big && *_frac1._big == *_frac2._big;
+        }
+
+        friend strong_ordering operator<=>(const basic_hybrid_fraction &_frac1, const basic_hybrid_fraction &_frac2) {
+            if (!_frac1._big && !_frac2._big) {
+                return _frac1._small <=> _frac2._small;
+            }
+            return _frac1.to_big() <=> _frac2.to_big();
+        }
+
+        // I/O operations:
+        friend ostream &operator<<(ostream &output, const basic_hybrid_fraction &_frac) {
+            if (_frac._big) {
+                return output << *_frac._big;
+            }
+            return output << _frac._small;
+        }
+
+        /**
+         * Reads "n d" or "n/d" like basic_fraction's operator>>, with no limit on the digits.
+         * @throw runtime_error (after setting failbit) when the input is not such a pair or the
+         * denominator is 0.
+         */
+        friend istream &operator>>(istream &input, basic_hybrid_fraction &_frac) {
+            BigFraction value;
+            input >> value;
+            _frac = std::move(value);
+            return input;
+        }
+
+    private:
+        /**
+         * The slow path: _frac1 op _frac2 computed in BigFraction, demoted when it fits.
+         */
+        static basic_hybrid_fraction promoted(const basic_hybrid_fraction &_frac1,
+                                              const basic_hybrid_fraction &_frac2, char op);
+    };
+
+    using HybridFraction = basic_hybrid_fraction<int64_t>;
+
+    template<fraction_integer IntT>
+    basic_hybrid_fraction<IntT> basic_hybrid_fraction<IntT>::promoted(const basic_hybrid_fraction &_frac1,
+                                                                       const basic_hybrid_fraction &_frac2, char op) {
+        BigFraction lhs = _frac1.to_big(), rhs = _frac2.to_big();
+        switch (op) {
+            case '+':
+                return lhs + rhs;
+            case '-':
+                return lhs - rhs;
+            case '*':
+                return lhs * rhs;
+            default:
+                return lhs / rhs;
+        }
+    }
+}
+#endif